@@ -0,0 +1,67 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "YABTE/BackTest/Book.hpp"
+#include "YABTE/Utilities/Concurrency/Executor.hpp"
+
+using arrow::Table, arrow::Result;
+using std::shared_ptr, std::vector;
+
+using YABTE::Utilities::Concurrency::Executor;
+
+namespace YABTE::BackTest {
+
+class StrategyRunnerResult;
+
+// performance of a book's daily total value. returns are simple day on day
+// returns, ratios are annualised with periods_per_year and use a zero risk
+// free rate. undefined values (e.g. sharpe with no variance) are NaN.
+struct PerformanceStats {
+    int64_t num_days = 0;
+    double total_return;
+    double annual_return;  // compound annual growth rate
+    double annual_volatility;
+    double sharpe_ratio;
+    double sortino_ratio;  // downside deviation over all returns
+    double max_drawdown;   // fraction of the running peak
+    int64_t max_drawdown_duration;  // longest stretch of days below a peak
+    double calmar_ratio;
+    double turnover;  // traded notional over mean total value
+    double exposure;  // mean of |mtm| / total
+};
+
+// core kernel over contiguous columns of length n. reductions are split
+// across independent accumulators so they vectorize, drawdowns take a
+// single sequential pass.
+PerformanceStats ComputePerformance(const double *total, const double *mtm,
+                                    const int64_t n,
+                                    const double traded_notional = 0.,
+                                    const double periods_per_year = 252.);
+
+// from a Book::history() table, float64 total and mtm columns
+Result<PerformanceStats> ComputePerformance(
+    const shared_ptr<Table> &history, const double traded_notional = 0.,
+    const double periods_per_year = 252.);
+
+// from a book's history and trades
+PerformanceStats ComputePerformance(const Book &book,
+                                    const double periods_per_year = 252.);
+
+// one row per book, a book name column followed by the stats. books are
+// computed in parallel on executor.
+shared_ptr<Table> PerformanceTable(const BookVector &books,
+                                   const double periods_per_year = 252.,
+                                   Executor &executor = Executor::shared());
+
+// one row per book of each result, prefixed by the result's index in run
+// column (e.g. the parameter set of run_batch)
+shared_ptr<Table> PerformanceTable(const vector<StrategyRunnerResult> &results,
+                                   const double periods_per_year = 252.,
+                                   Executor &executor = Executor::shared());
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+using std::shared_ptr;
+
+namespace YABTE::BackTest {
+
+struct ArenaStats {
+    int64_t bytes = 0;
+    int64_t allocations = 0;
+};
+
+// monotonic memory for the objects a run creates and keeps (orders, event
+// loop scratch). nothing is freed until the arena is destroyed, which is
+// when the run's result and the last object allocated from it are gone, so
+// short lived objects (e.g. per fill) belong on the heap or nowhere.
+// allocation is not thread safe, an arena belongs to the thread running
+// its run.
+class RunArena : public std::pmr::memory_resource {
+   public:
+    // upstream supplies the arena's blocks, e.g. a worker's pool so
+    // consecutive runs on a thread reuse memory
+    explicit RunArena(const size_t initial_size = 64 * 1024,
+                      std::pmr::memory_resource *upstream =
+                          std::pmr::new_delete_resource());
+
+    ArenaStats stats() const { return stats_; }
+
+    // arena of the run on this thread, null outside of a run
+    static const shared_ptr<RunArena> &current();
+
+   private:
+    friend class ArenaScope;
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {}
+    bool do_is_equal(
+        const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::monotonic_buffer_resource buffer_;
+    ArenaStats stats_;
+
+    static thread_local shared_ptr<RunArena> current_;
+};
+
+// makes arena current on this thread for the scope
+class ArenaScope {
+   public:
+    explicit ArenaScope(const shared_ptr<RunArena> &arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+   private:
+    shared_ptr<RunArena> previous_;
+};
+
+// allocator whose allocations keep their arena alive
+template <typename T>
+class ArenaAllocator {
+   public:
+    using value_type = T;
+
+    explicit ArenaAllocator(const shared_ptr<RunArena> &arena)
+        : arena_(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena_) {}
+
+    T *allocate(const size_t n) {
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *p, const size_t n) {
+        arena_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena_ == other.arena_;
+    }
+
+    shared_ptr<RunArena> arena_;
+};
+
+// make_shared from the current run's arena, or the heap outside a run. for
+// objects that live about as long as the run, see RunArena.
+template <typename T, typename... Args>
+shared_ptr<T> make_run_shared(Args &&...args) {
+    if (auto &arena = RunArena::current()) {
+        return std::allocate_shared<T>(ArenaAllocator<T>(arena),
+                                       std::forward<Args>(args)...);
+    }
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+}  // namespace YABTE::BackTest
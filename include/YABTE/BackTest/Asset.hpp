@@ -7,6 +7,9 @@
 #include <tuple>
 #include <vector>
 
+#include "YABTE/BackTest/ColumnPlan.hpp"
+#include "YABTE/BackTest/SymbolTable.hpp"
+#include "YABTE/BackTest/TableView.hpp"
 #include "YABTE/BackTest/common.hpp"
 
 using std::map, std::nullopt, std::optional, std::shared_ptr, std::string,
@@ -32,14 +35,22 @@ class Asset {
     virtual shared_ptr<Asset> clone() const = 0;
 
     double round_quantity(const double &quantity) const;
+    // prices are read from the full day data through columns_, see
+    // _resolve_columns
     virtual double intraday_traded_price(
-        const DayData &asset_day_data,
+        const DayView &day_data,
         const optional<double> size = nullopt) const = 0;
-    virtual double end_of_day_price(const DayData &asset_day_data) const = 0;
+    virtual double end_of_day_price(const DayView &day_data) const = 0;
 
     virtual vector<tuple<string, AssetDataFieldInfo>> data_fields() const = 0;
     vector<string> _get_fields(const AssetDataFieldInfo &field_info) const;
-    shared_ptr<DayData> _filter_data(const DayData &day_data) const;
+    // one row table of this asset's fields renamed without the data label
+    shared_ptr<arrow::Table> _filter_data(const DayView &day_data) const;
+
+    // resolve data_fields() against the runner's column plan (once per run)
+    AssetColumns _resolve_columns(const ColumnPlan &plan) const;
+    // value of the field at position field in data_fields(), NaN if missing
+    double _field_value(const DayView &day_data, const size_t field) const;
 
     string name_;
     string denom_;
@@ -47,13 +58,35 @@ class Asset {
     int quantity_round_dp_;
     string data_label_;
 
+    // attached during strategy runner
+    AssetColumns columns_;
+    AssetId id_ = NO_ASSET_ID;
+
    protected:
     Asset(const string &name, const string &denom, const int price_round_dp = 2,
           const int quantity_round_dp = 2,
           const optional<string> &data_label = nullopt);
 };
 
-using AssetMap = map<string, shared_ptr<Asset>>;
+// assets by name for strategies and the python api, and by dense id (see
+// SymbolTable) for the event loop. add assets with add() so both agree.
+class AssetMap : public map<string, shared_ptr<Asset>> {
+   public:
+    AssetMap();
+    explicit AssetMap(const shared_ptr<SymbolTable> &symbols);
+
+    // intern the asset's name and set its id_
+    void add(const shared_ptr<Asset> &asset);
+
+    using map::at;
+    const shared_ptr<Asset> &at(const AssetId id) const {
+        return by_id_.at(id);
+    }
+
+    shared_ptr<SymbolTable> symbols_;
+    vector<shared_ptr<Asset>> by_id_;
+};
+
 using AssetVector = vector<shared_ptr<Asset>>;
 
 class OHLCAsset : public Asset {
@@ -64,10 +97,13 @@ class OHLCAsset : public Asset {
 
     shared_ptr<Asset> clone() const override;
 
+    // positions in data_fields()
+    enum Field { HIGH = 0, LOW = 1, OPEN = 2, CLOSE = 3, VOLUME = 4 };
+
     double intraday_traded_price(
-        const DayData &asset_day_data,
+        const DayView &day_data,
         const optional<double> size = nullopt) const override;
-    double end_of_day_price(const DayData &asset_day_data) const override;
+    double end_of_day_price(const DayView &day_data) const override;
     vector<tuple<string, AssetDataFieldInfo>> data_fields() const override;
 };
 }  // namespace YABTE::BackTest
\ No newline at end of file
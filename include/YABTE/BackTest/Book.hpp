@@ -2,17 +2,23 @@
 
 #include <arrow/table.h>
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <vector>
 
 #include "YABTE/BackTest/Asset.hpp"
+#include "YABTE/BackTest/Ledger.hpp"
+#include "YABTE/BackTest/SymbolTable.hpp"
+#include "YABTE/BackTest/TableView.hpp"
 #include "YABTE/BackTest/Transaction.hpp"
 #include "YABTE/BackTest/common.hpp"
 
-using std::map, std::shared_ptr, std::string, std::vector, std::tuple;
+using std::map, std::optional, std::shared_ptr, std::string, std::vector,
+    std::tuple;
 
 using arrow::Table;
 
@@ -26,19 +32,52 @@ class Book {
     virtual shared_ptr<Book> clone() const;
 
     bool test_trades(const vector<shared_ptr<Trade>> &trades) const;
+    // test_trades for a single fill of an asset id, see _add_fill
+    bool test_fill(const AssetId id, const double quantity) const;
     void add_transactions(const TransactionVector &transactions);
-    void eod_tasks(const Timestamp &ts, const DayData &day_data,
+    void add_trades(const vector<shared_ptr<Trade>> &trades);
+    void add_cash(const Timestamp &ts, const double total, const string &desc);
+    void eod_tasks(const Timestamp &ts, const DayView &day_data,
                    const AssetMap &asset_map);
 
     shared_ptr<Table> history() const;
 
+    // transactions made from the ledger, and the ledger as a table sharing
+    // its buffers
+    TransactionVector transactions() const;
+    shared_ptr<Table> ledger() const;
+
+    // positions by asset name, for assets the book has traded
+    map<string, double> positions() const;
+    void set_position(const string &asset_name, const double quantity);
+
+    // re-key positions to symbols' ids (attached during strategy runner).
+    // afterwards trades and positions in assets symbols lacks are rejected
+    // instead of interned into the run's table.
+    void _bind_symbols(const shared_ptr<SymbolTable> &symbols);
+    // id of an asset name in symbols_, see _bind_symbols
+    AssetId _asset_id(const string &asset_name);
+    // position of an asset id, marking it held
+    double &_position(const AssetId id);
+    void _add_trade(const Trade &trade);
+    // a trade straight into the position, cash and ledger, without making
+    // a Trade
+    void _add_fill(const Timestamp &ts, const AssetId id,
+                   const double quantity, const double price,
+                   const double total, const optional<string> &label);
+
     string name_;
     string denom_;
     double cash_;
     double rate_;
     int interest_round_dp_;
-    map<string, double> positions_;
-    TransactionVector transactions_;
+    // positions by asset id in symbols_, held_ is set once an asset is
+    // traded (positions_ is 0 for the others)
+    shared_ptr<SymbolTable> symbols_;
+    bool symbols_bound_ = false;
+    vector<double> positions_;
+    vector<uint8_t> held_;
+    Ledger ledger_;
     vector<tuple<Timestamp, double, double, double>> _history_;
 };
 
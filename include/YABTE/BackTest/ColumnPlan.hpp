@@ -0,0 +1,51 @@
+#pragma once
+
+#include <arrow/type.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using std::map, std::optional, std::shared_ptr, std::string, std::tuple,
+    std::vector;
+
+namespace YABTE::BackTest {
+
+// location and type of a column in the runner's data table
+struct FieldColumn {
+    int index = -1;
+    arrow::Type::type type = arrow::Type::NA;
+
+    bool resolved() const { return index >= 0; }
+};
+
+// an asset's fields resolved against a data table, in the same order as
+// Asset::data_fields() so assets can address them by position
+struct AssetColumns {
+    int find(const string &field) const;
+
+    bool empty() const { return columns_.empty(); }
+    size_t size() const { return columns_.size(); }
+    const FieldColumn &operator[](size_t i) const { return columns_[i]; }
+
+    vector<string> fields_;
+    vector<FieldColumn> columns_;
+};
+
+// column resolution plan built once per run from the data schema, maps
+// data label -> field name -> column so the event loop never parses
+// column names
+class ColumnPlan {
+   public:
+    ColumnPlan() = default;
+    explicit ColumnPlan(const shared_ptr<arrow::Schema> &schema);
+
+    FieldColumn find(const string &data_label, const string &field) const;
+
+    map<string, map<string, FieldColumn>> columns_;
+};
+
+}  // namespace YABTE::BackTest
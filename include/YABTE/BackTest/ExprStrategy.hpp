@@ -0,0 +1,94 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "YABTE/BackTest/Strategy.hpp"
+
+using std::shared_ptr, std::string, std::vector;
+
+namespace YABTE::BackTest {
+
+// a node of a parsed rule expression
+struct ExprNode {
+    enum class Kind {
+        NUMBER,  // number
+        NAME,    // parameter, or otherwise the asset's field (e.g. Close)
+        CALL,    // name(args...), see ExprStrategy
+        UNARY,   // name is "-" or "not"
+        BINARY,  // name is the operator, args are its operands
+    };
+
+    Kind kind;
+    double number = 0.;
+    string name;
+    vector<shared_ptr<const ExprNode>> args;
+    // offset in the source, for errors
+    size_t pos = 0;
+};
+
+// condition -> buy|sell size
+struct ExprRule {
+    shared_ptr<const ExprNode> condition;
+    bool buy;
+    shared_ptr<const ExprNode> size;
+};
+
+// parse rules separated by ';' or new lines, '#' starts a comment. throws
+// std::invalid_argument with the offending offset on syntax errors.
+vector<ExprRule> ParseExprRules(const string &source);
+
+// A strategy written as rules over one asset, e.g.
+//
+//   cross(sma(Close, n), sma(Close, m)) -> buy 100
+//   cross(sma(Close, m), sma(Close, n)) -> sell 100
+//
+// parsed once when constructed. each run substitutes its params_ for
+// names, evaluates every distinct subexpression once over the whole data
+// (rolling kernels on data columns go through indicators_) and adds the
+// rules' conditions and sizes as columns ('<data label>', 'rule_<i>') and
+// ('<data label>', 'size_<i>') in extend_data. on_close then places a
+// SimpleOrder for each rule whose condition holds on the day, in rule
+// order, without leaving C++.
+//
+// expressions use numbers, names, + - * /, < <= > >= == !=, and, or, not,
+// parentheses and
+//
+//   sma(x, n) ema(x, span) sum(x, n) min(x, n) max(x, n) std(x, n)
+//   var(x, n) zscore(x, n) rank(x, n)  rolling kernels, see Rolling.hpp
+//   cross(a, b)                        a crosses above b
+//   lag(x, k)                          x k rows earlier
+//   abs(x)
+//
+// where windows, spans and lags are numbers or parameters.
+class ExprStrategy : public Strategy {
+   public:
+    ExprStrategy(const string &source, const string &asset_name);
+
+    shared_ptr<Strategy> clone() const override;
+    shared_ptr<const Table> extend_data(
+        const shared_ptr<const Table> &data) override;
+    void on_close() override;
+    // rows the rules read before the current one, counting an ema as four
+    // spans
+    int64_t lookback() const override;
+
+    string source_;
+    string asset_name_;
+    vector<ExprRule> rules_;
+
+   private:
+    // data label of the asset, its name when the asset isn't known
+    string _data_label() const;
+
+    // column indices in data_ of each rule's condition and size, found on
+    // the first close (a streamed window only has them from then on)
+    vector<int> condition_columns_;
+    vector<int> size_columns_;
+};
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "YABTE/Utilities/Concurrency/Executor.hpp"
+
+using arrow::ChunkedArray, arrow::Result;
+using std::shared_ptr, std::string, std::vector, std::variant, std::map;
+
+using YABTE::Utilities::Concurrency::Executor;
+
+namespace YABTE::BackTest {
+
+// a single strategy parameter, see ParamMap
+using ParamValue = variant<double, string, bool, int>;
+
+// derived columns keyed by (source column, kernel, params), shared by the
+// runs of a batch so each distinct indicator is computed once. the source
+// is identified by its buffers, which the cache keeps alive, so equal keys
+// always mean equal content. safe to use from several runs at once; when
+// two runs ask for the same missing column one computes it and the other
+// waits for the result.
+class IndicatorCache {
+   public:
+    using Compute = std::function<Result<shared_ptr<ChunkedArray>>()>;
+
+    // arguments of one compute() call
+    struct Request {
+        shared_ptr<ChunkedArray> source;
+        string function;
+        vector<ParamValue> params;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t entries = 0;
+    };
+
+    // cached column or the result of compute, which is called at most once
+    // per key. failures are returned but not cached.
+    Result<shared_ptr<ChunkedArray>> get_or_compute(
+        const shared_ptr<ChunkedArray> &source, const string &kernel,
+        const vector<ParamValue> &params, const Compute &compute);
+
+    // call a registered arrow compute function (e.g. yabte_rolling_mean)
+    // with the source followed by params as scalars
+    Result<shared_ptr<ChunkedArray>> compute(
+        const shared_ptr<ChunkedArray> &source, const string &function,
+        const vector<ParamValue> &params = {});
+
+    // compute() each request on the executor's workers, e.g. every
+    // indicator a sweep will ask for before running it. returns the first
+    // failure, the other requests are still cached.
+    arrow::Status precompute(const vector<Request> &requests,
+                             Executor &executor = Executor::shared());
+
+    Stats stats() const;
+    void clear();
+
+   private:
+    // (values address, validity bitmap address, offset, length) of each
+    // chunk
+    using SourceId =
+        vector<std::tuple<uintptr_t, uintptr_t, int64_t, int64_t>>;
+    using Key = std::tuple<SourceId, int, string, vector<ParamValue>>;
+
+    struct Entry {
+        shared_ptr<ChunkedArray> source;
+        std::shared_future<Result<shared_ptr<ChunkedArray>>> value;
+    };
+
+    static Key _key(const shared_ptr<ChunkedArray> &source,
+                    const string &kernel, const vector<ParamValue> &params);
+
+    mutable std::mutex mutex_;
+    map<Key, Entry> entries_;
+    std::atomic<uint64_t> hits_ = 0;
+    std::atomic<uint64_t> misses_ = 0;
+};
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "YABTE/BackTest/Order.hpp"
+#include "YABTE/BackTest/Strategy.hpp"
+
+using std::optional, std::nullopt, std::shared_ptr, std::string, std::vector;
+
+namespace YABTE::BackTest {
+
+// an order placed by a lane, equivalent to a SimpleOrder
+struct LaneOrder {
+    size_t lane;
+    size_t asset;  // index into LaneOrders::asset_names_
+    double size;
+    OrderSizeType size_type;
+    optional<string> book_name;
+    optional<string> label;
+};
+
+// orders placed by lane strategies during open or close, processed in the
+// order they were placed like the runner's order queue
+class LaneOrders {
+   public:
+    LaneOrders() = default;
+    LaneOrders(const vector<string> &asset_names, const size_t num_lanes);
+
+    void push(const size_t lane, const string &asset_name, const double size,
+              const OrderSizeType size_type = OrderSizeType::QUANTITY,
+              const optional<string> &book_name = nullopt,
+              const optional<string> &label = nullopt);
+
+    size_t num_lanes() const { return num_lanes_; }
+    size_t size() const { return orders_.size(); }
+    bool empty() const { return orders_.empty(); }
+
+    // asset names in name order, positions are kept in this order
+    vector<string> asset_names_;
+    size_t num_lanes_ = 0;
+    vector<LaneOrder> orders_;
+};
+
+// A strategy that simulates several parameter sets (lanes) in one pass
+// over the data, see StrategyRunner::run_lockstep. Each day the runner
+// calls on_open_lanes/on_close_lanes once for all lanes; orders pushed for
+// lane i are booked exactly as if run(lane_params_[i]) had placed them.
+// data_ is a window over the runner's data (extend_data is not used) and
+// indicators_ can be used to build per lane columns in init_lanes.
+class LaneStrategy : public Strategy {
+   public:
+    virtual void init_lanes();
+    virtual void on_open_lanes(LaneOrders &orders);
+    virtual void on_close_lanes(LaneOrders &orders);
+
+    size_t num_lanes() const { return lane_params_.size(); }
+
+    // attached during strategy runner
+    vector<ParamMap> lane_params_;
+};
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <arrow/buffer.h>
+#include <arrow/table.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "YABTE/BackTest/SymbolTable.hpp"
+#include "YABTE/BackTest/Transaction.hpp"
+#include "YABTE/BackTest/common.hpp"
+
+using std::optional, std::shared_ptr, std::string, std::unordered_map,
+    std::vector;
+
+namespace YABTE::BackTest {
+
+enum class TransactionKind : int8_t { CASH = 0, TRADE = 1 };
+
+// append-only record of a book's transactions in structure of arrays form.
+// rows are written into chunks of kChunkRows rows of arrow buffers, so
+// appends don't allocate per row and to_table() shares the buffers. the
+// first chunk's buffers start small and double as it fills, so an empty
+// ledger allocates nothing and a small one little. Transaction objects are
+// only made on demand.
+class Ledger {
+   public:
+    static constexpr int64_t kChunkRows = 4096;
+    static constexpr int64_t kFirstChunkRows = 32;
+
+    Ledger() = default;
+    // full chunks are shared, the partly written last chunk is copied
+    Ledger(const Ledger &other);
+    Ledger &operator=(const Ledger &other);
+    Ledger(Ledger &&other) = default;
+    Ledger &operator=(Ledger &&other) = default;
+
+    // label is the order label of a trade or the description of a cash
+    // transaction, asset_id is NO_ASSET_ID for cash
+    void append(const Timestamp &ts, const TransactionKind kind,
+                const AssetId asset_id, const double quantity,
+                const double price, const double total,
+                const optional<string> &label);
+    void append_trade(const Timestamp &ts, const AssetId asset_id,
+                      const double quantity, const double price,
+                      const optional<string> &label);
+    void append_cash(const Timestamp &ts, const double total,
+                     const string &desc);
+
+    int64_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    int64_t num_trades() const { return num_trades_; }
+
+    Timestamp ts(const int64_t row) const;
+    TransactionKind kind(const int64_t row) const;
+    AssetId asset_id(const int64_t row) const;
+    double quantity(const int64_t row) const;
+    double price(const int64_t row) const;
+    double total(const int64_t row) const;
+    optional<string> label(const int64_t row) const;
+
+    // asset names come from symbols
+    shared_ptr<Transaction> transaction(const int64_t row,
+                                        const SymbolTable &symbols) const;
+    TransactionVector transactions(const SymbolTable &symbols) const;
+
+    // ts, kind, asset, quantity, price, total, label columns, one arrow
+    // chunk per ledger chunk. kind, asset and label are dictionary encoded
+    // over the ledger's buffers, only the dictionaries are built.
+    shared_ptr<arrow::Table> to_table(const SymbolTable &symbols) const;
+
+   private:
+    struct Chunk {
+        shared_ptr<arrow::Buffer> ts, kind, asset, asset_valid, quantity,
+            price, total, label, label_valid;
+        // rows the buffers have room for, at most kChunkRows
+        int64_t capacity = 0;
+    };
+
+    static Chunk make_chunk(const int64_t capacity);
+    // chunk with room for capacity rows, starting with chunk's rows. the
+    // buffers that to_table() may have shared are left as they are.
+    static Chunk copy_chunk(const Chunk &chunk, const int64_t capacity);
+
+    template <typename T>
+    T value(const shared_ptr<arrow::Buffer> Chunk::*column,
+            const int64_t row) const {
+        auto &chunk = chunks_[row / kChunkRows];
+        return reinterpret_cast<const T *>(
+            (chunk.*column)->data())[row % kChunkRows];
+    }
+
+    int32_t intern_label(const string &label);
+
+    vector<Chunk> chunks_;
+    int64_t size_ = 0;
+    int64_t num_trades_ = 0;
+    vector<string> labels_;
+    unordered_map<string, int32_t> label_ids_;
+};
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "YABTE/BackTest/Strategy.hpp"
+
+using arrow::Table;
+using std::shared_ptr, std::string, std::vector, std::tuple;
+
+namespace YABTE::BackTest {
+
+class StrategyRunnerResult;
+
+// reduces a run to a single value, see StrategyRunner::run_batch_summary
+using Metric = std::function<double(const StrategyRunnerResult &)>;
+using MetricVector = vector<tuple<string, Metric>>;
+
+namespace Metrics {
+
+// the metrics below use equity, the sum of the books' total value per day
+
+// equity at the end of the run
+double final_equity(const StrategyRunnerResult &result);
+
+// as PerformanceStats of the equity with 252 periods per year
+double sharpe_ratio(const StrategyRunnerResult &result);
+double max_drawdown(const StrategyRunnerResult &result);
+
+// number of trades booked across all books
+double trade_count(const StrategyRunnerResult &result);
+
+// the metrics above, keyed by function name
+const MetricVector &builtin();
+
+// builtin metric by name, throws std::out_of_range if unknown
+Metric by_name(const string &name);
+
+}  // namespace Metrics
+
+// one row per parameter set, the parameter columns (in name order, null
+// where a set omits a parameter) followed by a float64 column per metric
+shared_ptr<Table> SummaryTable(const vector<ParamMap> &params_vector,
+                               const vector<string> &metric_names,
+                               const vector<vector<double>> &values);
+
+}  // namespace YABTE::BackTest
@@ -7,8 +7,10 @@
 #include <tuple>
 #include <vector>
 
+#include "YABTE/BackTest/Arena.hpp"
 #include "YABTE/BackTest/Asset.hpp"
 #include "YABTE/BackTest/Book.hpp"
+#include "YABTE/BackTest/TableView.hpp"
 #include "YABTE/BackTest/Transaction.hpp"
 #include "YABTE/BackTest/common.hpp"
 
@@ -43,7 +45,7 @@ class Order {
 
     virtual void post_complete(const vector<shared_ptr<Trade>> trades);
 
-    virtual void apply(const Timestamp &ts, const DayData &day_data,
+    virtual void apply(const Timestamp &ts, const DayView &day_data,
                        const AssetMap &asset_map) = 0;
 
     OrderStatus status_;
@@ -70,13 +72,18 @@ class SimpleOrder : public Order {
     string asset_name_;
     double size_;
     OrderSizeType size_type_;
+    // resolved from asset_name_ on first apply
+    AssetId asset_id_ = NO_ASSET_ID;
 
     optional<OrderStatus> pre_execute_check(const Timestamp &ts,
                                             const double trade_price) const;
-    tuple<double, double> _calc_quantity_price(const DayData &day_data,
+    tuple<double, double> _calc_quantity_price(const DayView &day_data,
                                                const AssetMap &asset_map) const;
 
-    void apply(const Timestamp &ts, const DayData &day_data,
+    // a SimpleOrder fills straight into book_'s ledger, testing the fill
+    // without making a Trade. subclasses book a Trade through
+    // _book_trades, so test_trades and post_complete are called for them.
+    void apply(const Timestamp &ts, const DayView &day_data,
                const AssetMap &asset_map) override;
 };
 }  // namespace YABTE::BackTest
\ No newline at end of file
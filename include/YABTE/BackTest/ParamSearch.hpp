@@ -0,0 +1,121 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "YABTE/BackTest/Strategy.hpp"
+
+using arrow::Table;
+using std::shared_ptr, std::string, std::vector, std::variant, std::map;
+
+namespace YABTE::BackTest {
+
+// integers low, low + step, ... up to high inclusive
+struct IntRange {
+    int low;
+    int high;
+    int step = 1;
+};
+
+// doubles in [low, high], sampled uniformly in log space when log is set
+// (low must then be positive)
+struct DoubleRange {
+    double low;
+    double high;
+    bool log = false;
+};
+
+// one of values, e.g. strings or bools
+struct Choice {
+    vector<ParamValue> values;
+};
+
+using ParamDomain = variant<IntRange, DoubleRange, Choice>;
+// the values each parameter may take, keyed by parameter name
+using ParamSpace = map<string, ParamDomain>;
+
+enum class SearchMethod {
+    RANDOM,           // independent uniform samples
+    LATIN_HYPERCUBE,  // each parameter's range split into num_trials strata,
+                      // each stratum sampled once
+    TPE,              // tree-structured parzen estimator, see ParamSearch
+};
+
+struct SearchOptions {
+    SearchMethod method = SearchMethod::TPE;
+    int64_t num_trials = 64;
+    uint64_t seed = 0;
+    // maximize the objective, minimize when false
+    bool maximize = true;
+    // trials run at once, the executor's workers when 0
+    unsigned max_parallelism = 0;
+
+    // TPE: latin hypercube trials before the model is used
+    int64_t startup_trials = 10;
+    // TPE: fraction of the completed trials that make up the good group
+    double gamma = 0.25;
+    // TPE: candidates drawn from the good group's density per parameter
+    int num_candidates = 24;
+};
+
+// trials of a search in trial order, NaN where a trial has no value
+struct SearchResult {
+    vector<ParamMap> params_;
+    vector<double> values_;
+    // index of the best trial, -1 when none has a value
+    int64_t best_ = -1;
+
+    // params and objective column, see SummaryTable
+    shared_ptr<Table> summary(const string &objective = "objective") const;
+};
+
+// ask/tell sampler over a ParamSpace. random and latin hypercube trials are
+// fixed by the seed. TPE samples the startup trials as a latin hypercube,
+// then for each parameter draws candidates from a density fitted to the
+// best gamma fraction of the values told so far and keeps the candidate
+// most likely under it relative to the rest. asked trials don't need to be
+// told in order, so trials can run concurrently; a TPE trial then depends
+// on which trials finished first. thread safe.
+class ParamSearch {
+   public:
+    ParamSearch(const ParamSpace &space, const SearchOptions &options = {});
+
+    // params of trial 0 <= trial < num_trials
+    ParamMap ask(const int64_t trial);
+    // the objective of an asked trial, NaN counts as the worst value
+    void tell(const int64_t trial, const double value);
+
+    SearchResult result() const;
+
+   private:
+    // each trial is a point in the unit cube, one coordinate per parameter.
+    // a choice of k values maps value i to (i + 0.5) / k.
+    using Point = vector<double>;
+
+    Point _tpe_point();
+    ParamMap _decode(const Point &point) const;
+
+    vector<string> names_;
+    vector<ParamDomain> domains_;
+    SearchOptions options_;
+
+    mutable std::mutex mutex_;
+    std::mt19937_64 rng_;
+    // design of the random or latin hypercube trials, or of the TPE
+    // startup trials
+    vector<Point> design_;
+    vector<Point> points_;
+    vector<double> values_;
+    vector<bool> asked_;
+    vector<bool> told_;
+};
+
+}  // namespace YABTE::BackTest
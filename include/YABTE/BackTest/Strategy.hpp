@@ -6,17 +6,20 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "YABTE/BackTest/Asset.hpp"
 #include "YABTE/BackTest/Book.hpp"
+#include "YABTE/BackTest/IndicatorCache.hpp"
 #include "YABTE/BackTest/Order.hpp"
+#include "YABTE/BackTest/TableView.hpp"
 
 using arrow::Table;
 using std::make_shared, std::shared_ptr, std::string, std::variant, std::map;
 
 namespace YABTE::BackTest {
 
-using ParamMap = map<string, variant<double, string, bool, int>>;
+using ParamMap = map<string, ParamValue>;
 
 // allow variants to be printed
 template <class Var, class = std::variant_alternative_t<0, Var>>
@@ -39,14 +42,49 @@ class Strategy {
     virtual shared_ptr<const Table> extend_data(
         const shared_ptr<const Table>& data);
 
+    // rows before the current one that on_open/on_close read, directly or
+    // through extend_data's columns. StrategyRunner::run_stream keeps only
+    // this many earlier rows.
+    virtual int64_t lookback() const;
+
+    // rows per on_close_block call, read once after init. above 1, the
+    // runner calls on_close_block at the close of the first day of each
+    // block instead of on_close every day, e.g. so a python strategy
+    // crosses into the interpreter once per block. 1 by default.
+    virtual int64_t block_size() const;
+
+    // orders for the closes of rows [begin, end), one list per row, with
+    // data_ advanced to end for the call. the runner places each row's
+    // orders at its close, so they are processed as if on_close placed
+    // them. only for strategies whose orders follow from the data: a
+    // row's orders must use no later rows and see the books as they were
+    // at begin.
+    virtual std::vector<std::vector<shared_ptr<Order>>> on_close_block(
+        const int64_t begin, const int64_t end);
+
     // attached/copied during strategy runner
     ParamMap params_;
     shared_ptr<AssetMap> asset_map_;
     shared_ptr<BookMap> book_map_;
     shared_ptr<OrderDeque> orders_;
 
-    // writable during init, readable during open/close
-    shared_ptr<Table> data_ = nullptr;
+    // derived columns shared with the other runs of a batch, or in
+    // run_stream with the other strategies for the current window
+    shared_ptr<IndicatorCache> indicators_;
+
+    // window over the (extended) data, empty during init and grows a row
+    // per day during open/close. writable during init. in run_stream it
+    // holds only the rows from base(), see DataWindow.
+    shared_ptr<DataWindow> data_ = nullptr;
+
+    // orders of the current block, kept by the runner between closes
+    struct CloseBlock {
+        // block_size() when above 1, otherwise 0
+        int64_t size = 0;
+        int64_t begin = 0;
+        std::vector<std::vector<shared_ptr<Order>>> orders;
+    };
+    CloseBlock close_block_;
 
     //    protected:
     Strategy() = default;
@@ -7,14 +7,22 @@
 
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
+#include "YABTE/BackTest/Arena.hpp"
 #include "YABTE/BackTest/Asset.hpp"
 #include "YABTE/BackTest/Book.hpp"
+#include "YABTE/BackTest/IndicatorCache.hpp"
+#include "YABTE/BackTest/Metrics.hpp"
 #include "YABTE/BackTest/Order.hpp"
+#include "YABTE/BackTest/ParamSearch.hpp"
 #include "YABTE/BackTest/Strategy.hpp"
+#include "YABTE/Utilities/Concurrency/Executor.hpp"
 
 #ifdef EXPER_PY_SUB_INTERP
 #include <pybind11/embed.h>
@@ -24,9 +32,10 @@
 
 using arrow::Table;
 using std::shared_ptr, std::string, std::vector, std::variant, std::map,
-    std::optional, std::nullopt;
+    std::optional, std::nullopt, std::tuple;
 
 using YABTE::BackTest::ParamMap;
+using YABTE::Utilities::Concurrency::Executor;
 
 #ifdef EXPER_PY_SUB_INTERP
 using YABTE::Utilities::Python::Interpreter,
@@ -40,7 +49,11 @@ class StrategyRunnerResult {
     StrategyRunnerResult();
 
     shared_ptr<Table> book_history() const;
+    // memory the run allocated from its arena
+    ArenaStats arena_stats() const;
 
+    // first so it outlives the orders and trades allocated from it
+    shared_ptr<RunArena> arena_;
     shared_ptr<OrderDeque> orders_unprocessed_;
     OrderDeque orders_processed_;
 
@@ -49,6 +62,58 @@ class StrategyRunnerResult {
     AssetVector assets_;
 };
 
+// a run started by StrategyRunner::_start that is advanced a range of days
+// at a time, e.g. so a sweep can stop runs early and resume the rest
+struct RunState {
+    StrategyRunnerResult result_;
+    shared_ptr<AssetMap> asset_map_;
+    shared_ptr<BookMap> book_map_;
+    ParamMap params_;
+    // first data row not yet run
+    int64_t next_row_ = 0;
+};
+
+struct HalvingOptions {
+    // share of the data rows every candidate runs before the first cut
+    double min_fraction = 1. / 3.;
+    // each rung keeps the best 1 / eta of the candidates and runs them
+    // eta times as many rows, the last rung runs to the end of the data
+    double eta = 3.;
+    // maximize the objective, minimize when false
+    bool maximize = true;
+    // runs advanced at once, the executor's workers when 0
+    unsigned max_parallelism = 0;
+};
+
+struct HalvingResult {
+    // every candidate with its objective at the last rung it reached and
+    // the number of data rows it ran
+    vector<ParamMap> params_;
+    vector<double> values_;
+    vector<int64_t> rows_;
+
+    // candidates that ran to the end of the data, best first, and their
+    // results
+    vector<int64_t> finalists_;
+    vector<StrategyRunnerResult> results_;
+
+    // params, objective and rows columns, see SummaryTable
+    shared_ptr<Table> summary(const string& objective = "objective") const;
+};
+
+enum class SignalKind {
+    TARGET_POSITION,  // each close orders the difference to the position
+    ORDER_SIZE,       // each close orders the signal's quantity
+};
+
+struct SignalOptions {
+    SignalKind kind = SignalKind::TARGET_POSITION;
+    // each asset's signal is column ('<data label>', field)
+    string field = "Target";
+    // book the orders fill in, the first book when not set
+    optional<string> book_name;
+};
+
 class StrategyRunner {
    public:
     StrategyRunner(const shared_ptr<Table>& data, const AssetVector& assets,
@@ -60,10 +125,103 @@ class StrategyRunner {
 
     StrategyRunnerResult run(const ParamMap& params = {});
 
+    // runs on the executor, num_threads limits how many run at once
+    // (all of the executor's workers when not set)
     vector<StrategyRunnerResult> run_batch(
         const vector<ParamMap>& params_vector,
         const optional<unsigned int> num_threads = nullopt);
 
+    // run_batch reducing each run to metrics as soon as it finishes, so
+    // only one row per parameter set is kept, see SummaryTable. each
+    // worker reuses one memory pool for the arenas of its runs.
+    shared_ptr<Table> run_batch_summary(
+        const vector<ParamMap>& params_vector,
+        const MetricVector& metrics = Metrics::builtin(),
+        const optional<unsigned int> num_threads = nullopt);
+
+    // run_batch_summary in num_processes forked worker processes (the
+    // machine's cores when not set), e.g. for python strategies, which
+    // share the GIL in threads. data_ is published once to posix shared
+    // memory as an arrow ipc file that every worker maps without copying;
+    // each runs every num_processes-th parameter set on a single thread
+    // and streams its metric rows back over a pipe. throws if a worker
+    // fails.
+    shared_ptr<Table> run_batch_summary_processes(
+        const vector<ParamMap>& params_vector,
+        const MetricVector& metrics = Metrics::builtin(),
+        const optional<unsigned int> num_processes = nullopt);
+
+    // search space for the parameters optimizing objective, running up to
+    // options.max_parallelism trials at once on the executor. each TPE
+    // trial is sampled from the trials finished so far.
+    SearchResult run_search(const ParamSpace& space, const Metric& objective,
+                            const SearchOptions& options = {});
+
+    // successive halving: every parameter set runs the first rows of the
+    // data, the best by objective carry on from where they stopped (their
+    // books, orders and strategies are kept, nothing is rerun) over more
+    // rows, the rest are dropped, until the survivors reach the end
+    HalvingResult run_halving(const vector<ParamMap>& params_vector,
+                              const Metric& objective,
+                              const HalvingOptions& options = {});
+
+    StrategyRunnerResult _run(const ParamMap& params,
+                              const shared_ptr<IndicatorCache>& indicators,
+                              std::pmr::memory_resource* arena_upstream =
+                                  std::pmr::new_delete_resource());
+
+    // body of a run_batch_summary_processes worker: map the data published
+    // as data_name and run parameter sets first, first + stride, ...
+    // writing them to fd. returns the process's exit code.
+    int _process_worker(const string& data_name,
+                        const vector<ParamMap>& params_vector,
+                        const MetricVector& metrics, const int64_t first,
+                        const int64_t stride, const int fd);
+
+    // cloned strategies, books and assets with init() called, no days run
+    RunState _start(const ParamMap& params,
+                    const shared_ptr<IndicatorCache>& indicators,
+                    std::pmr::memory_resource* arena_upstream =
+                        std::pmr::new_delete_resource());
+    // run state's days from its next row up to end_row of day_table, a
+    // view of data_
+    void _advance(RunState& state, const TableView& day_table,
+                  const int64_t end_row) const;
+
+    // run without strategy callbacks or order objects: each asset's signal
+    // column, from data_ or a strategy's extend_data (with params), sets
+    // the quantity of an order placed at each close where it is not null,
+    // filled at the next day's traded price as SimpleOrder would. a day's
+    // orders fill in asset name order. books, history and ledgers match
+    // run() with a strategy placing those orders from on_close, whose
+    // orders are materialized only for the result.
+    StrategyRunnerResult run_signals(const ParamMap& params = {},
+                                     const SignalOptions& options = {});
+
+    // run over data read a batch at a time instead of data_, holding only
+    // the current batch and the strategies' lookback rows (plus one) before
+    // it. extend_data is called on each of these windows, with indicators_
+    // a cache that is cleared for each window, and a warning is logged for
+    // a strategy whose extended columns need more rows than its lookback().
+    StrategyRunnerResult run_stream(
+        const shared_ptr<arrow::RecordBatchReader>& reader,
+        const ParamMap& params = {});
+
+    // sorted unique asset names, the ids of a run's SymbolTable
+    vector<string> _asset_names() const;
+
+    // clone strategies, books and assets into result, resolving asset
+    // columns against schema
+    tuple<shared_ptr<AssetMap>, shared_ptr<BookMap>> _prepare(
+        StrategyRunnerResult& result,
+        const shared_ptr<arrow::Schema>& schema) const;
+
+    // simulate every parameter set in a single pass over the data. all
+    // strategies must be LaneStrategy, results match calling run() with
+    // each parameter set.
+    vector<StrategyRunnerResult> run_lockstep(
+        const vector<ParamMap>& params_vector);
+
     shared_ptr<Table> data_;
     AssetVector assets_;
     // in python, we accepted types and instantiated them
@@ -71,6 +229,28 @@ class StrategyRunner {
     // we will instantiate before and attach internal data.
     StrategyVector strategies_;
     BookVector books_;
+
+    // when set, indicators are cached across runs and batches, otherwise
+    // each run or batch gets its own cache
+    shared_ptr<IndicatorCache> indicator_cache_;
+
+    // batches run here, Executor::shared() when not set
+    shared_ptr<Executor> executor_;
+    Executor& _executor() const;
+
+    // data_ as a TableView, its chunks combined once and shared by every
+    // run until data_ is replaced
+    shared_ptr<const TableView> _day_table() const;
+
+    // the view _day_table() built and the data_ it was built from, shared
+    // by copies of the runner
+    struct DayTableCache {
+        std::mutex mutex;
+        shared_ptr<Table> data;
+        shared_ptr<const TableView> view;
+    };
+    shared_ptr<DayTableCache> day_table_cache_ =
+        std::make_shared<DayTableCache>();
 };
 
 }  // namespace YABTE::BackTest
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using std::string, std::unordered_map, std::vector;
+
+namespace YABTE::BackTest {
+
+// dense asset id, an index into a SymbolTable
+using AssetId = int32_t;
+inline constexpr AssetId NO_ASSET_ID = -1;
+
+// interns asset names to dense ids 0..size()-1. there is one per run so
+// assets and positions can be flat vectors indexed by id, names are only
+// looked up at the api boundary.
+class SymbolTable {
+   public:
+    SymbolTable() = default;
+    // names are interned in the given order
+    explicit SymbolTable(const vector<string> &names);
+
+    AssetId intern(const string &name);
+    // NO_ASSET_ID when name was never interned
+    AssetId find(const string &name) const;
+    // id of an interned name, throws out_of_range otherwise
+    AssetId id(const string &name) const;
+
+    const string &name(const AssetId id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+
+    vector<string> names_;
+    unordered_map<string, AssetId> ids_;
+};
+
+}  // namespace YABTE::BackTest
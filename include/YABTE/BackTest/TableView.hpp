@@ -0,0 +1,156 @@
+#pragma once
+
+#include <arrow/table.h>
+#include <arrow/util/bit_util.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "YABTE/BackTest/ColumnPlan.hpp"
+
+using std::shared_ptr, std::string, std::vector;
+
+namespace YABTE::BackTest {
+
+// raw typed pointers into a contiguous (single chunk) column
+struct ColumnView {
+    arrow::Type::type type = arrow::Type::NA;
+    const uint8_t *validity = nullptr;
+    const uint8_t *values = nullptr;
+    int64_t offset = 0;
+    int64_t length = 0;
+
+    bool is_valid(const int64_t row) const {
+        return validity == nullptr ||
+               arrow::bit_util::GetBit(validity, offset + row);
+    }
+
+    // raw value, caller is responsible for the type matching
+    template <typename T>
+    T value(const int64_t row) const {
+        return reinterpret_cast<const T *>(values)[offset + row];
+    }
+
+    // numeric value widened to double, NaN when null
+    double as_double(const int64_t row) const;
+};
+
+// column views over a table whose columns have been combined into single
+// chunks, built once per data (see StrategyRunner::_day_table) so rows can
+// be addressed without allocation
+class TableView {
+   public:
+    TableView() = default;
+    explicit TableView(const shared_ptr<const arrow::Table> &table);
+
+    int64_t num_rows() const { return num_rows_; }
+    int num_columns() const { return static_cast<int>(columns_.size()); }
+    const ColumnView &column(const int i) const { return columns_[i]; }
+    int column_index(const string &name) const;
+
+    shared_ptr<arrow::Table> table_;
+    vector<ColumnView> columns_;
+    int64_t num_rows_ = 0;
+};
+
+// a single row of a TableView, this is what the event loop hands to
+// orders, assets and books each day
+class DayView {
+   public:
+    DayView(const TableView &table, const int64_t row)
+        : table_(&table), row_(row) {}
+
+    bool is_valid(const int column) const {
+        return table_->column(column).is_valid(row_);
+    }
+    double value(const int column) const {
+        return table_->column(column).as_double(row_);
+    }
+    double value(const FieldColumn &column) const {
+        return column.resolved() ? value(column.index) : std::nan("");
+    }
+
+    // one row table for adapters (e.g. python overrides) that need one
+    shared_ptr<arrow::Table> to_table() const;
+
+    const TableView *table_;
+    int64_t row_;
+};
+
+class WindowColumn;
+
+// growing window over a strategy's data, rows [0, size()) are visible.
+// moving the window is O(1) and never copies or allocates. when streaming
+// the table only holds rows [base(), base() + rows) and older rows can no
+// longer be read.
+class DataWindow {
+   public:
+    DataWindow() = default;
+    explicit DataWindow(const shared_ptr<const arrow::Table> &table,
+                        const int64_t size = 0);
+
+    int64_t size() const { return size_; }
+    int64_t base() const { return base_; }
+    void advance() { advance_to(size_ + 1); }
+    void advance_to(const int64_t size);
+
+    // replace the table with one whose first row is row base, size() is
+    // kept so it must lie within the new rows
+    void rebase(const shared_ptr<const arrow::Table> &table,
+                const int64_t base);
+
+    int column_index(const string &name) const;
+    WindowColumn column(const string &name) const;
+    WindowColumn column(const int index) const;
+
+    // row in the underlying table, offset is from the start of the window
+    // and counts back from the end when negative
+    int64_t _row(const int64_t offset) const;
+
+    // zero copy slices of the visible rows that are still held, row base()
+    // first, so their row i is offset base() + i
+    shared_ptr<arrow::Table> table() const;
+    shared_ptr<arrow::ChunkedArray> array(const string &name) const;
+
+    TableView view_;
+    int64_t size_ = 0;
+    int64_t base_ = 0;
+};
+
+// typed accessors for a column of a DataWindow, follows the window as it
+// advances
+class WindowColumn {
+   public:
+    WindowColumn(const DataWindow &window, const int index)
+        : window_(&window), index_(index) {}
+
+    // value k rows back from the latest visible row, last(0) is the latest.
+    // doubles are widened from any numeric type and are NaN when null.
+    template <typename T = double>
+    T last(const int64_t k = 0) const {
+        return at<T>(-1 - k);
+    }
+
+    template <typename T = double>
+    T at(const int64_t offset) const {
+        auto row = window_->_row(offset);
+        auto &col = window_->view_.column(index_);
+        if constexpr (std::is_same_v<T, double>)
+            return col.as_double(row);
+        else
+            return col.template value<T>(row);
+    }
+
+    bool is_valid(const int64_t offset) const {
+        return window_->view_.column(index_).is_valid(window_->_row(offset));
+    }
+
+    const DataWindow *window_;
+    int index_;
+};
+
+}  // namespace YABTE::BackTest
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "YABTE/BackTest/SymbolTable.hpp"
 #include "YABTE/BackTest/common.hpp"
 
 using std::string, std::string_literals::operator""s, std::optional,
@@ -43,6 +44,8 @@ class Trade : public Transaction {
     double price_;
     string asset_name_;
     optional<string> order_label_;
+    // set for trades booked by orders during a run, see SymbolTable
+    AssetId asset_id_ = NO_ASSET_ID;
 };
 
 }  // namespace YABTE::BackTest
\ No newline at end of file
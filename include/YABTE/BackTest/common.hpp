@@ -16,11 +16,6 @@ inline Timestamp timestamp_from_ns(const arrow::TimestampType::c_type &ns) {
         std::chrono::nanoseconds(ns));
 }
 
-/* ideally DayData would be a map like
-DayData = map<string, variant<string, double>>
-*/
-using DayData = arrow::Table;
-
 inline double round_n_digits(const double &value, const int &n) {
     return round(value * pow(10, n)) / pow(10, n);
 }
\ No newline at end of file
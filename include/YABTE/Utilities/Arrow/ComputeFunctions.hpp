@@ -0,0 +1,40 @@
+#pragma once
+
+#include <arrow/api.h>
+#include <arrow/compute/registry.h>
+
+#include <string>
+#include <vector>
+
+using std::string, std::vector;
+
+using arrow::Status;
+
+namespace YABTE::Utilities::Arrow {
+
+// Registers the kernels in Rolling.hpp as vector compute functions so they
+// can be called through arrow::compute::CallFunction, expressions or
+// pyarrow.compute.call_function. Window parameters are passed as trailing
+// scalar arguments,
+//
+//   yabte_rolling_sum(values, window[, min_periods])
+//   yabte_rolling_mean(values, window[, min_periods])
+//   yabte_rolling_min(values, window[, min_periods])
+//   yabte_rolling_max(values, window[, min_periods])
+//   yabte_rolling_rank(values, window[, min_periods])
+//   yabte_rolling_var(values, window[, min_periods[, ddof]])
+//   yabte_rolling_std(values, window[, min_periods[, ddof]])
+//   yabte_rolling_zscore(values, window[, min_periods[, ddof]])
+//   yabte_ema(values, span[, min_periods])
+//   yabte_crossover(a, b)
+//
+// integer parameters are int64 scalars and the ema span is a float64 scalar.
+// registering more than once is a no-op. a null registry means the global
+// one.
+Status RegisterComputeFunctions(
+    arrow::compute::FunctionRegistry *registry = nullptr);
+
+// names of the functions added by RegisterComputeFunctions
+const vector<string> &ComputeFunctionNames();
+
+}  // namespace YABTE::Utilities::Arrow
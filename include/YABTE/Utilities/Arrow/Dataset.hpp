@@ -0,0 +1,48 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "YABTE/Utilities/Arrow/Loaders.hpp"
+
+using std::shared_ptr, std::string, std::vector;
+
+using arrow::Result, arrow::Table;
+
+namespace YABTE::Utilities::Arrow {
+
+// a directory of parquet files partitioned by asset (and e.g. year), each
+// file holding a date column and unprefixed fields (Open, Close, ...).
+// from LoadOptions, assets select partitions, fields select file columns
+// and the date range prunes row groups and rows. memory_map and columns
+// are not used.
+struct DatasetOptions : LoadOptions {
+    // partition field holding the asset name
+    string asset_partition = "symbol";
+
+    // directory partition field names (e.g. {"symbol", "year"} for
+    // GOOG/2020/...), hive style (symbol=GOOG/year=2020/...) when empty
+    vector<string> partition_fields;
+
+    // scan threads, arrow's cpu thread pool when 0
+    int num_threads = 0;
+
+    // files and batches per file decoded ahead of the consumer, bounding
+    // the memory held by the scan beyond the result
+    int fragment_readahead = 4;
+    int batch_readahead = 4;
+};
+
+// scan the dataset under root and align the assets on date into the
+// runner's wide layout: a timestamp[ns] date column (in the source's time
+// zone) over the union of all assets' dates followed by ('ASSET', 'Field')
+// columns, assets in name order, null where an asset has no row for a
+// date. dates are scanned first, then each asset's fields in turn, so
+// beside the result only one asset's rows are held at a time.
+Result<shared_ptr<Table>> LoadDataset(const string &root,
+                                      const DatasetOptions &options = {});
+
+}  // namespace YABTE::Utilities::Arrow
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
+using std::optional, std::nullopt, std::shared_ptr, std::string,
+    std::chrono::nanoseconds;
+
+using arrow::Result, arrow::Table;
+
+namespace YABTE::Utilities::Arrow {
+
+enum class AsOfDirection {
+    BACKWARD,  // last right row at or before the left date
+    FORWARD,   // first right row at or after the left date
+};
+
+struct AsOfJoinOptions {
+    // date column of both tables, each must be sorted ascending without
+    // nulls. any timestamp or date type, compared as nanoseconds.
+    string on = "Date";
+    AsOfDirection direction = AsOfDirection::BACKWARD;
+
+    // furthest a matched right date may be from the left date, unbounded
+    // when not set. rows without a match are null.
+    optional<nanoseconds> tolerance = nullopt;
+
+    // when false a right row with the same date does not match, e.g. so
+    // data published on a day is only seen the day after
+    bool allow_exact_matches = true;
+};
+
+// right's columns (without the date column) aligned to left's rows by a
+// single sort-merge pass over the dates. where the matched rows are
+// contiguous (e.g. identical dates) the columns are zero copy slices of
+// right, otherwise they are gathered with one take per column.
+Result<shared_ptr<Table>> AsOfAlign(const shared_ptr<const Table> &left,
+                                    const shared_ptr<const Table> &right,
+                                    const AsOfJoinOptions &options = {});
+
+// left with AsOfAlign's columns appended
+Result<shared_ptr<Table>> AsOfJoin(const shared_ptr<const Table> &left,
+                                   const shared_ptr<const Table> &right,
+                                   const AsOfJoinOptions &options = {});
+
+}  // namespace YABTE::Utilities::Arrow
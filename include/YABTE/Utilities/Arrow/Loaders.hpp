@@ -0,0 +1,96 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using std::optional, std::nullopt, std::shared_ptr, std::string, std::vector,
+    std::chrono::system_clock, std::chrono::time_point;
+
+using arrow::Result, arrow::Table;
+
+namespace YABTE::Utilities::Arrow {
+
+enum class FileFormat {
+    AUTO,  // from the extension, parquet if unknown
+    PARQUET,
+    ORC,
+    IPC,  // arrow ipc file, i.e. feather v2 (v1 is also read)
+};
+
+// what to read from a data file. the defaults read the whole file.
+struct LoadOptions {
+    FileFormat format = FileFormat::AUTO;
+
+    // map the file instead of reading it into buffers, pages are only
+    // faulted in for the row groups and columns that are decoded
+    bool memory_map = false;
+
+    // keep "('ASSET', 'Field')" columns whose asset and field are listed,
+    // an empty list matches any. the date column and any columns named in
+    // columns are always kept.
+    vector<string> assets;
+    vector<string> fields;
+    vector<string> columns;
+
+    // keep rows with start <= date < end. parquet row groups whose date
+    // statistics lie outside the range are skipped without decoding.
+    string date_column = "Date";
+    optional<time_point<system_clock>> start = nullopt;
+    optional<time_point<system_clock>> end = nullopt;
+
+    // decode columns on arrow's cpu thread pool
+    bool use_threads = false;
+
+    // when set, LoadTable keeps the prepared table (options applied, date
+    // as timestamp[ns], contiguous columns) in this directory as an
+    // uncompressed ipc file keyed by the source file and options. later
+    // loads map that file without decoding or copying. files for earlier
+    // versions of the source are removed when a new one is written, and a
+    // cache that can't be written is only logged.
+    optional<string> cache_dir = nullopt;
+
+    bool selects_columns() const {
+        return !assets.empty() || !fields.empty() || !columns.empty();
+    }
+};
+
+// indices of the schema's fields kept by options
+vector<int> SelectFields(const shared_ptr<arrow::Schema> &schema,
+                         const LoadOptions &options);
+
+// rows of table with start <= date < end, table itself when no range set
+Result<shared_ptr<Table>> FilterDateRange(const shared_ptr<Table> &table,
+                                          const LoadOptions &options);
+
+// load a parquet, orc or ipc file, see LoadOptions::format. the date
+// column is timestamp[ns] (keeping any time zone) whether or not the
+// table comes from the cache.
+Result<shared_ptr<Table>> LoadTable(const string &path,
+                                    const LoadOptions &options = {});
+
+Result<shared_ptr<Table>> LoadParquetTable(const string &path,
+                                           const LoadOptions &options = {});
+
+// orc stripes are not pruned, rows outside the date range are dropped
+// after reading
+Result<shared_ptr<Table>> LoadOrcTable(const string &path,
+                                       const LoadOptions &options = {});
+
+// with memory_map an uncompressed file is read without copying
+Result<shared_ptr<Table>> LoadIpcTable(const string &path,
+                                       const LoadOptions &options = {});
+
+// date column as timestamp[ns], keeping any time zone
+Result<shared_ptr<Table>> NormalizeDates(const shared_ptr<Table> &table,
+                                         const LoadOptions &options = {});
+
+// NormalizeDates and each column in a single chunk
+Result<shared_ptr<Table>> PrepareTable(const shared_ptr<Table> &table,
+                                       const LoadOptions &options = {});
+
+}  // namespace YABTE::Utilities::Arrow
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <memory>
+
+using std::shared_ptr;
+
+using arrow::Result, arrow::ChunkedArray;
+
+namespace YABTE::Utilities::Arrow {
+
+// Streaming rolling window kernels. Each runs in a single O(n) pass over
+// the column regardless of window length, accepts any numeric chunked
+// array and returns a single chunk float64 array aligned with the input.
+// Nulls and NaNs are treated as missing; an output is null unless its
+// window holds at least min_periods (defaults to window) valid values.
+
+Result<shared_ptr<ChunkedArray>> RollingSum(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods = -1);
+
+// simple moving average
+Result<shared_ptr<ChunkedArray>> RollingMean(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods = -1);
+
+Result<shared_ptr<ChunkedArray>> RollingVar(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods = -1, int ddof = 1);
+
+Result<shared_ptr<ChunkedArray>> RollingStd(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods = -1, int ddof = 1);
+
+// min/max via a monotonic deque of window positions
+Result<shared_ptr<ChunkedArray>> RollingMin(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods = -1);
+
+Result<shared_ptr<ChunkedArray>> RollingMax(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods = -1);
+
+// (value - rolling mean) / rolling std
+Result<shared_ptr<ChunkedArray>> RollingZScore(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods = -1, int ddof = 1);
+
+// average rank (1 based, ties averaged) of each value within its window,
+// null where the value itself is missing. unlike the other kernels this is
+// O(n log n): the window's values are counted in a fenwick tree over the
+// column's sorted distinct values.
+Result<shared_ptr<ChunkedArray>> RollingRank(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods = -1);
+
+// exponential moving average with alpha = 2 / (span + 1), not adjusted
+// (i.e. y[i] = (1 - alpha) * y[i - 1] + alpha * x[i]). missing values
+// carry the previous average forward.
+Result<shared_ptr<ChunkedArray>> ExponentialMovingAverage(
+    const shared_ptr<ChunkedArray> &vals, double span,
+    int64_t min_periods = 1);
+
+// boolean column, true where a crosses above b, i.e. a < b on the previous
+// row and a > b on this one. null on the first row and where any of the
+// four values is missing.
+Result<shared_ptr<ChunkedArray>> Crossover(const shared_ptr<ChunkedArray> &a,
+                                           const shared_ptr<ChunkedArray> &b);
+
+}  // namespace YABTE::Utilities::Arrow
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+using std::shared_ptr, std::string;
+
+using arrow::Result, arrow::Table;
+
+namespace YABTE::Utilities::Arrow {
+
+// a table written once as an arrow ipc file of a single record batch into
+// a posix shared memory object, so other processes (forked or spawned) can
+// map it without copying. the object is unlinked when this is destroyed,
+// mappings made before stay valid.
+class SharedTable {
+   public:
+    // publish table under name (e.g. "/yabte_data"), a name unique to
+    // this process when empty
+    static Result<shared_ptr<SharedTable>> Publish(
+        const shared_ptr<Table> &table, const string &name = "");
+
+    // map a published table read only. its buffers point into the
+    // mapping, which is released with the last of them.
+    static Result<shared_ptr<Table>> Map(const string &name);
+
+    SharedTable(const SharedTable &) = delete;
+    SharedTable &operator=(const SharedTable &) = delete;
+    ~SharedTable();
+
+    const string &name() const { return this->name_; }
+    // bytes of the ipc file
+    int64_t size() const { return this->size_; }
+
+   private:
+    SharedTable(const string &name, const int64_t size)
+        : name_(name), size_(size) {}
+
+    string name_;
+    int64_t size_;
+};
+
+}  // namespace YABTE::Utilities::Arrow
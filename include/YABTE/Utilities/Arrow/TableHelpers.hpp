@@ -9,8 +9,13 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
+#include <tuple>
 #include <vector>
 
+#include "YABTE/Utilities/Arrow/Join.hpp"
+#include "YABTE/Utilities/Arrow/Loaders.hpp"
+
 using std::shared_ptr, std::string, std::vector, std::chrono::system_clock,
     std::chrono::time_point, std::chrono::nanoseconds;
 
@@ -53,13 +58,23 @@ struct ConversionTraits<time_point<system_clock>>
 
 namespace YABTE::Utilities::Arrow {
 
-Result<shared_ptr<Table>> LoadTable(string path);
+// split a "('ASSET', 'Field')" column name into its label and field,
+// neither of which may contain spaces
+std::optional<std::tuple<string, string>> ParseColumnName(const string &name);
 
+// lagged simple moving average, row i is the mean of the n rows before it
+// and NaN (not null) for the first n rows. see Rolling.hpp for the general
+// rolling kernels, which return nulls.
 Result<shared_ptr<ChunkedArray>> ComputeMovingAverage(
     shared_ptr<ChunkedArray> vals, int n);
 
-Result<shared_ptr<Table>> ExtendTable(const shared_ptr<const Table> &base_table,
-                                      const shared_ptr<const Table> &ext_table);
+// base with ext's columns appended, the rows are taken to line up and ext
+// must have as many. with as_of, ext is instead aligned on base's dates by
+// AsOfAlign (see Join.hpp), which needs both sorted without null dates.
+Result<shared_ptr<Table>> ExtendTable(
+    const shared_ptr<const Table> &base_table,
+    const shared_ptr<const Table> &ext_table,
+    const optional<AsOfJoinOptions> &as_of = nullopt);
 
 Result<shared_ptr<Table>> HorizConcatTables(
     vector<shared_ptr<const Table>> &tables, vector<string> &field_prefixes);
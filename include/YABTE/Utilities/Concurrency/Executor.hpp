@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using std::shared_ptr, std::unique_ptr, std::vector;
+
+namespace YABTE::Utilities::Concurrency {
+
+struct ExecutorOptions {
+    // worker threads, hardware concurrency when 0
+    unsigned num_threads = 0;
+    // pin worker i to cpu i (modulo the cpu count), linux only
+    bool pin_threads = false;
+};
+
+// long lived pool of worker threads. each worker has its own task deque,
+// taking its newest task first and stealing the oldest task of another
+// worker when its own is empty, so tasks submitted from a worker stay on
+// that worker while the others balance the load.
+class Executor {
+   public:
+    explicit Executor(const ExecutorOptions &options = {});
+    // runs the tasks already submitted, then joins the workers
+    ~Executor();
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    // library wide executor with default options, started on first use
+    // (in a forked child, first use in that child)
+    static Executor &shared();
+
+    unsigned num_threads() const {
+        return static_cast<unsigned>(workers_.size());
+    }
+
+    // index of the calling thread among this executor's workers, -1 when
+    // not one of them
+    int worker_index() const { return current_ == this ? current_index_ : -1; }
+
+    template <typename F>
+    auto submit(F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task =
+            std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        auto future = task->get_future();
+        this->_push([task] { (*task)(); });
+        return future;
+    }
+
+    // f(i) for every i in [begin, end) with at most max_parallelism calls
+    // running at once (num_threads() when 0), returning when all are done.
+    // the first exception stops further calls and is rethrown. a worker
+    // calling this runs pending tasks while it waits, so nested calls
+    // don't deadlock, and blocks once there are none as the remaining
+    // calls are then running on other threads.
+    template <typename F>
+    void parallel_for(const int64_t begin, const int64_t end, F &&f,
+                      const unsigned max_parallelism = 0);
+
+   private:
+    using Task = std::function<void()>;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void _push(Task task);
+    // run one pending task, own newest first then the oldest of the others
+    bool _try_run_one(const int index);
+    void _worker_loop(const int index, const bool pin);
+
+    vector<unique_ptr<Worker>> workers_;
+    std::mutex wait_mutex_;
+    std::condition_variable wake_;
+    // tasks queued but not yet taken by a worker
+    std::atomic<int64_t> pending_ = 0;
+    std::atomic<unsigned> next_worker_ = 0;
+    bool stop_ = false;
+
+    static thread_local const Executor *current_;
+    static thread_local int current_index_;
+};
+
+template <typename F>
+void Executor::parallel_for(const int64_t begin, const int64_t end, F &&f,
+                            const unsigned max_parallelism) {
+    if (end <= begin) return;
+
+    struct State {
+        std::atomic<int64_t> next;
+        int64_t end;
+        std::atomic<unsigned> active;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    auto limit = max_parallelism ? max_parallelism : this->num_threads();
+    auto runners = static_cast<unsigned>(
+        std::min<int64_t>(std::max(limit, 1u), end - begin));
+
+    State state;
+    state.next = begin;
+    state.end = end;
+    state.active = runners;
+
+    // each runner takes the next index until none are left
+    auto runner = [&state, &f] {
+        for (auto i = state.next++; i < state.end; i = state.next++) {
+            try {
+                f(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (!state.error) state.error = std::current_exception();
+                state.next = state.end;
+            }
+        }
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (--state.active == 0) state.done.notify_all();
+    };
+    for (unsigned r = 0; r < runners; ++r) this->_push(runner);
+
+    if (auto index = this->worker_index(); index >= 0) {
+        while (state.active > 0 && this->_try_run_one(index)) {
+        }
+    }
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.done.wait(lock, [&state] { return state.active == 0; });
+    if (state.error) std::rethrow_exception(state.error);
+}
+
+// one T per worker of an executor, e.g. scratch memory reused by every
+// task a worker runs without locking. each is constructed from args.
+template <typename T>
+class WorkerLocal {
+   public:
+    template <typename... Args>
+    explicit WorkerLocal(const Executor &executor, const Args &...args)
+        : executor_(executor) {
+        for (unsigned i = 0; i < executor.num_threads(); ++i)
+            this->values_.emplace_back(args...);
+    }
+
+    // the calling worker's value
+    T &local() {
+        auto index = this->executor_.worker_index();
+        if (index < 0) throw std::logic_error("Not an executor worker");
+        return this->values_[index];
+    }
+
+   private:
+    const Executor &executor_;
+    // deque so T needn't be movable
+    std::deque<T> values_;
+};
+
+}  // namespace YABTE::Utilities::Concurrency
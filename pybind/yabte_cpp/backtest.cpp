@@ -1,6 +1,9 @@
+#include <arrow/c/bridge.h>
 #include <arrow/python/pyarrow.h>
 // #include <pybind11/iostream.h>
+#include <pybind11/chrono.h>
 #include <pybind11/gil.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
@@ -12,16 +15,27 @@
 #define VERSION_INFO __TIMESTAMP__
 
 #include "./stl_bind_deque.h"
+#include "YABTE/BackTest/Analytics.hpp"
 #include "YABTE/BackTest/Asset.hpp"
 #include "YABTE/BackTest/Book.hpp"
+#include "YABTE/BackTest/ExprStrategy.hpp"
+#include "YABTE/BackTest/Metrics.hpp"
 #include "YABTE/BackTest/Order.hpp"
 #include "YABTE/BackTest/Strategy.hpp"
 #include "YABTE/BackTest/StrategyRunner.hpp"
 #include "YABTE/BackTest/Transaction.hpp"
+#include "YABTE/Utilities/Arrow/ComputeFunctions.hpp"
+#include "YABTE/Utilities/Arrow/Join.hpp"
+#include "YABTE/Utilities/Arrow/Rolling.hpp"
+#include "YABTE/Utilities/Arrow/SharedMemory.hpp"
 #include "YABTE/Utilities/Arrow/TableHelpers.hpp"
+#include "YABTE/Utilities/Concurrency/Executor.hpp"
 
 using namespace YABTE::BackTest;
 
+namespace yua = YABTE::Utilities::Arrow;
+namespace yuc = YABTE::Utilities::Concurrency;
+
 using std::vector, std::tuple, std::shared_ptr, std::optional, std::nullopt,
     std::make_shared, std::string;
 
@@ -42,6 +56,99 @@ class PyTransaction : public Transaction {
     }
 };
 
+// numpy arrays of a window's visible rows by column name. float64 and
+// timestamp columns without nulls are read only views of the arrow
+// buffers, other float, int and bool columns are copied to float64 with
+// NaN for nulls, remaining columns are left out.
+py::dict numpy_columns(const DataWindow &w) {
+    auto &view = w.view_;
+    auto rows = w.size() - w.base();
+    // the views' base keeps the table's buffers alive
+    auto owner = py::capsule(new shared_ptr<arrow::Table>(view.table_),
+                             [](void *p) {
+                                 delete static_cast<shared_ptr<arrow::Table> *>(
+                                     p);
+                             });
+
+    py::dict columns;
+    for (int i = 0; i < view.num_columns(); ++i) {
+        auto &col = view.column(i);
+        auto &field = view.table_->schema()->field(i);
+        py::array array;
+        if (col.type == arrow::Type::DOUBLE && !col.validity) {
+            array = py::array_t<double>(
+                rows, reinterpret_cast<const double *>(col.values) + col.offset,
+                owner);
+        } else if (col.type == arrow::Type::TIMESTAMP && !col.validity) {
+            static const char *units[] = {"s", "ms", "us", "ns"};
+            auto unit = std::static_pointer_cast<arrow::TimestampType>(
+                            field->type())
+                            ->unit();
+            array = py::array(
+                py::dtype(std::format("datetime64[{}]",
+                                      units[static_cast<int>(unit)])),
+                {rows}, {sizeof(int64_t)},
+                reinterpret_cast<const int64_t *>(col.values) + col.offset,
+                owner);
+        } else if (col.type == arrow::Type::DOUBLE ||
+                   col.type == arrow::Type::FLOAT ||
+                   col.type == arrow::Type::INT64 ||
+                   col.type == arrow::Type::INT32 ||
+                   col.type == arrow::Type::BOOL) {
+            py::array_t<double> copy(rows);
+            auto out = copy.mutable_data();
+            for (int64_t r = 0; r < rows; ++r) out[r] = col.as_double(r);
+            array = copy;
+        } else {
+            continue;
+        }
+        array.attr("setflags")(py::arg("write") = false);
+        columns[py::str(field->name())] = array;
+    }
+    return columns;
+}
+
+// a python callable as a Metric, called with the gil from any worker. the
+// last copy may be dropped on a worker too, so it is released with the gil.
+Metric py_metric(const py::object &f) {
+    auto held = shared_ptr<py::object>(new py::object(f), [](py::object *p) {
+        py::gil_scoped_acquire gil;
+        delete p;
+    });
+    return [held](const StrategyRunnerResult &result) {
+        py::gil_scoped_acquire gil;
+        auto value =
+            (*held)(py::cast(&result, py::return_value_policy::reference));
+        return value.cast<double>();
+    };
+}
+
+// a builtin metric's name, a callable (named by its __name__) or a
+// (name, callable) tuple
+tuple<string, Metric> py_named_metric(const py::object &spec) {
+    if (py::isinstance<py::str>(spec)) {
+        auto name = spec.cast<string>();
+        return {name, Metrics::by_name(name)};
+    }
+    if (py::isinstance<py::tuple>(spec)) {
+        auto pair = spec.cast<py::tuple>();
+        if (pair.size() == 2 && py::isinstance<py::function>(pair[1]))
+            return {pair[0].cast<string>(), py_metric(pair[1])};
+    } else if (py::isinstance<py::function>(spec)) {
+        return {spec.attr("__name__").cast<string>(), py_metric(spec)};
+    }
+    throw py::type_error(
+        "A metric is a name, a callable or a (name, callable) tuple");
+}
+
+// the builtin metrics when none are given
+MetricVector py_metrics(const optional<vector<py::object>> &specs) {
+    if (!specs.has_value()) return Metrics::builtin();
+    MetricVector metrics;
+    for (auto &spec : specs.value()) metrics.push_back(py_named_metric(spec));
+    return metrics;
+}
+
 // For cloning idioms, see:
 // https://github.com/pybind/pybind11/issues/1049#issuecomment-326688270
 
@@ -65,6 +172,26 @@ class PyStrategy : public Strategy {
     void init() override { PYBIND11_OVERRIDE(void, Strategy, init); };
     void on_open() override { PYBIND11_OVERRIDE(void, Strategy, on_open); };
     void on_close() override { PYBIND11_OVERRIDE(void, Strategy, on_close); };
+    int64_t lookback() const override {
+        PYBIND11_OVERRIDE(int64_t, Strategy, lookback);
+    };
+    int64_t block_size() const override {
+        PYBIND11_OVERRIDE(int64_t, Strategy, block_size);
+    };
+
+    // python overrides receive numpy_columns of the window up to the end
+    // of the block and the index of its first row in those arrays, and
+    // return a list of orders per row of the block
+    vector<vector<shared_ptr<Order>>> on_close_block(
+        const int64_t begin, const int64_t end) override {
+        py::gil_scoped_acquire gil;
+        py::function override = py::get_override(
+            static_cast<const Strategy *>(this), "on_close_block");
+        if (!override) return Strategy::on_close_block(begin, end);
+        auto columns = numpy_columns(*this->data_);
+        return override(columns, begin - this->data_->base())
+            .cast<vector<vector<shared_ptr<Order>>>>();
+    };
 
     shared_ptr<const Table> extend_data(
         // inline PYBIND11_OVERRIDE macro and adjust wrap/unwrap
@@ -115,14 +242,21 @@ class PyAsset : public Asset {
         return shared_ptr<Asset>(keep_python_state_alive, ptr);
     }
 
+    // python overrides still receive the asset's one row pyarrow table
     double intraday_traded_price(
-        const DayData &asset_day_data,
+        const DayView &day_data,
         const optional<double> size = nullopt) const override {
+        py::gil_scoped_acquire gil;
+        auto asset_day_data = py::reinterpret_steal<py::object>(
+            arrow::py::wrap_table(this->_filter_data(day_data)));
         PYBIND11_OVERRIDE_PURE(double, Asset, intraday_traded_price,
                                asset_day_data, size);
     }
 
-    double end_of_day_price(const DayData &asset_day_data) const override {
+    double end_of_day_price(const DayView &day_data) const override {
+        py::gil_scoped_acquire gil;
+        auto asset_day_data = py::reinterpret_steal<py::object>(
+            arrow::py::wrap_table(this->_filter_data(day_data)));
         PYBIND11_OVERRIDE_PURE(double, Asset, end_of_day_price, asset_day_data);
     };
 
@@ -167,13 +301,40 @@ class PyOrder : public Order {
         PYBIND11_OVERRIDE(void, Order, post_complete, trades);
     };
 
-    void apply(Timestamp &ts, DayData &day_data, AssetMap &asset_map) {
-        PYBIND11_OVERRIDE_PURE(void, Order, apply, ts, day_data, asset_map);
+    // python overrides still receive the day's one row pyarrow table
+    void apply(const Timestamp &ts, const DayView &day_data,
+               const AssetMap &asset_map) override {
+        py::gil_scoped_acquire gil;
+        auto day_table = py::reinterpret_steal<py::object>(
+            arrow::py::wrap_table(day_data.to_table()));
+        PYBIND11_OVERRIDE_PURE(void, Order, apply, ts, day_table, asset_map);
     };
 };
 
 PYBIND11_MAKE_OPAQUE(AssetMap)
 PYBIND11_MAKE_OPAQUE(BookMap)
+// pyarrow Array or ChunkedArray, neither is copied
+shared_ptr<arrow::ChunkedArray> unwrap_values(const py::handle &obj) {
+    if (arrow::py::is_chunked_array(obj.ptr())) {
+        auto status = arrow::py::unwrap_chunked_array(obj.ptr());
+        if (status.ok()) return status.ValueOrDie();
+    } else if (arrow::py::is_array(obj.ptr())) {
+        auto status = arrow::py::unwrap_array(obj.ptr());
+        if (status.ok())
+            return make_shared<arrow::ChunkedArray>(status.ValueOrDie());
+    }
+    throw py::type_error("Expected a pyarrow Array or ChunkedArray");
+}
+
+py::object wrap_values(
+    const arrow::Result<shared_ptr<arrow::ChunkedArray>> &result) {
+    if (!result.ok()) {
+        throw std::runtime_error("Error: " + result.status().ToString());
+    }
+    return py::reinterpret_steal<py::object>(
+        arrow::py::wrap_chunked_array(result.ValueOrDie()));
+}
+
 PYBIND11_MAKE_OPAQUE(OrderDeque)
 // PYBIND11_MAKE_OPAQUE(TransactionVector)
 
@@ -199,6 +360,137 @@ PYBIND11_MODULE(yabte_cpp_backtest, m) {
 
     // py::add_ostream_redirect(m, "ostream_redirect");
 
+    // compute kernels, also registered with arrow so they're available via
+    // pyarrow.compute.call_function("yabte_rolling_mean", [values, 20])
+    if (auto status = yua::RegisterComputeFunctions(); !status.ok()) {
+        throw std::runtime_error("Error: " + status.ToString());
+    }
+
+    auto compute = m.def_submodule("compute", "Rolling window kernels");
+    compute.attr("function_names") = yua::ComputeFunctionNames();
+
+    using WindowKernel = arrow::Result<shared_ptr<arrow::ChunkedArray>> (*)(
+        const shared_ptr<arrow::ChunkedArray> &, int64_t, int64_t);
+    for (auto [name, kernel] : vector<tuple<const char *, WindowKernel>>{
+             {"rolling_sum", yua::RollingSum},
+             {"rolling_mean", yua::RollingMean},
+             {"rolling_min", yua::RollingMin},
+             {"rolling_max", yua::RollingMax},
+             {"rolling_rank", yua::RollingRank}}) {
+        compute.def(
+            name,
+            [kernel](py::handle values, int64_t window, int64_t min_periods) {
+                return wrap_values(
+                    kernel(unwrap_values(values), window, min_periods));
+            },
+            py::arg("values"), py::arg("window"), py::arg("min_periods") = -1);
+    }
+
+    using MomentKernel = arrow::Result<shared_ptr<arrow::ChunkedArray>> (*)(
+        const shared_ptr<arrow::ChunkedArray> &, int64_t, int64_t, int);
+    for (auto [name, kernel] : vector<tuple<const char *, MomentKernel>>{
+             {"rolling_var", yua::RollingVar},
+             {"rolling_std", yua::RollingStd},
+             {"rolling_zscore", yua::RollingZScore}}) {
+        compute.def(
+            name,
+            [kernel](py::handle values, int64_t window, int64_t min_periods,
+                     int ddof) {
+                return wrap_values(
+                    kernel(unwrap_values(values), window, min_periods, ddof));
+            },
+            py::arg("values"), py::arg("window"), py::arg("min_periods") = -1,
+            py::arg("ddof") = 1);
+    }
+
+    compute.def(
+        "ema",
+        [](py::handle values, double span, int64_t min_periods) {
+            return wrap_values(yua::ExponentialMovingAverage(
+                unwrap_values(values), span, min_periods));
+        },
+        py::arg("values"), py::arg("span"), py::arg("min_periods") = 1);
+
+    compute.def(
+        "crossover",
+        [](py::handle a, py::handle b) {
+            return wrap_values(
+                yua::Crossover(unwrap_values(a), unwrap_values(b)));
+        },
+        py::arg("a"), py::arg("b"));
+
+    // as-of join on the date, e.g. for irregular data in extend_data (which
+    // returns just the right table's columns, they are appended by position)
+    m.def(
+        "as_of_join",
+        [](py::handle left, py::handle right, const string &on,
+           const string &direction, const optional<std::chrono::nanoseconds>
+                                        &tolerance,
+           bool allow_exact_matches) {
+            auto st_l = arrow::py::unwrap_table(left.ptr());
+            auto st_r = arrow::py::unwrap_table(right.ptr());
+            if (!st_l.ok() || !st_r.ok()) {
+                throw std::runtime_error(
+                    "Error converting pyarrow table to arrow table");
+            }
+            if (direction != "backward" && direction != "forward") {
+                throw py::value_error("direction must be backward or forward");
+            }
+
+            yua::AsOfJoinOptions options;
+            options.on = on;
+            options.direction = direction == "backward"
+                                    ? yua::AsOfDirection::BACKWARD
+                                    : yua::AsOfDirection::FORWARD;
+            options.tolerance = tolerance;
+            options.allow_exact_matches = allow_exact_matches;
+
+            auto result = yua::AsOfJoin(st_l.ValueOrDie(), st_r.ValueOrDie(),
+                                        options);
+            if (!result.ok()) {
+                throw std::runtime_error("Error: " +
+                                         result.status().ToString());
+            }
+            return py::reinterpret_steal<py::object>(
+                arrow::py::wrap_table(result.ValueOrDie()));
+        },
+        py::arg("left"), py::arg("right"), py::arg("on") = "Date",
+        py::arg("direction") = "backward", py::arg("tolerance") = nullopt,
+        py::arg("allow_exact_matches") = true);
+
+    // tables in posix shared memory, e.g. for spawned worker processes
+    py::class_<yua::SharedTable, shared_ptr<yua::SharedTable>>(m,
+                                                               "SharedTable")
+        .def_static(
+            "publish",
+            [](pybind11::object py_table, const string &name) {
+                auto status = arrow::py::unwrap_table(py_table.ptr());
+                if (!status.ok()) {
+                    throw std::runtime_error(
+                        "Error converting pyarrow table to arrow table");
+                }
+                auto result =
+                    yua::SharedTable::Publish(status.ValueOrDie(), name);
+                if (!result.ok()) {
+                    throw std::runtime_error("Error: " +
+                                             result.status().ToString());
+                }
+                return result.ValueOrDie();
+            },
+            py::arg("table"), py::arg("name") = "")
+        .def_static("map",
+                    [](const string &name) {
+                        auto result = yua::SharedTable::Map(name);
+                        if (!result.ok()) {
+                            throw std::runtime_error(
+                                "Error: " + result.status().ToString());
+                        }
+                        return py::reinterpret_steal<py::object>(
+                            arrow::py::wrap_table(result.ValueOrDie()));
+                    })
+        .def_property_readonly("name", &yua::SharedTable::name)
+        .def_property_readonly("size", &yua::SharedTable::size);
+
     // transaction
     py::class_<Transaction, PyTransaction, shared_ptr<Transaction>>(
         m, "Transaction");
@@ -233,10 +525,28 @@ PYBIND11_MODULE(yabte_cpp_backtest, m) {
         .def(py::init<string, string, double, double, int>(), py::arg("name"),
              py::arg("denom") = "USD", py::arg("cash") = 0.,
              py::arg("rate") = 0., py::arg("interest_round_dp") = 3)
-        .def_readonly("transactions", &Book::transactions_)
+        .def_property_readonly("transactions", &Book::transactions)
+        .def_property_readonly("ledger",
+                               [](const Book &b) -> py::handle {
+                                   return arrow::py::wrap_table(b.ledger());
+                               })
+        .def_property_readonly("positions", &Book::positions)
+        .def("set_position", &Book::set_position, py::arg("asset_name"),
+             py::arg("quantity"))
         .def_property_readonly("history", [](const Book &b) -> py::handle {
             return arrow::py::wrap_table(b.history());
-        });
+        })
+        .def(
+            "performance",
+            [](const shared_ptr<Book> &b, const double periods_per_year,
+               const shared_ptr<yuc::Executor> &executor) {
+                return py::reinterpret_steal<py::object>(
+                    arrow::py::wrap_table(PerformanceTable(
+                        BookVector{b}, periods_per_year,
+                        executor ? *executor : yuc::Executor::shared())));
+            },
+            py::arg("periods_per_year") = 252.,
+            py::arg("executor") = nullptr);
 
     py::bind_map<BookMap>(m, "BookMap");
 
@@ -257,7 +567,62 @@ PYBIND11_MODULE(yabte_cpp_backtest, m) {
         .value("REQUIRED", AssetDataFieldInfo::REQUIRED)
         .export_values();
 
-    py::bind_map<AssetMap>(m, "AssetMap");
+    // not bind_map, assets are set through add() so their ids and the
+    // run's symbols stay in step. no deletion as ids index by_id_.
+    py::class_<AssetMap>(m, "AssetMap")
+        .def(py::init<>())
+        .def("add", &AssetMap::add, py::arg("asset"))
+        .def("__setitem__",
+             [](AssetMap &map, const string &name,
+                const shared_ptr<Asset> &asset) {
+                 if (name != asset->name_) {
+                     throw py::value_error("Asset " + asset->name_ +
+                                           " set as " + name);
+                 }
+                 map.add(asset);
+             })
+        .def("__getitem__",
+             [](const AssetMap &map, const string &name) {
+                 auto it = map.find(name);
+                 if (it == map.end()) throw py::key_error(name);
+                 return it->second;
+             })
+        .def(
+            "get",
+            [](const AssetMap &map, const string &name) {
+                auto it = map.find(name);
+                return it == map.end() ? nullptr : it->second;
+            },
+            py::arg("name"))
+        .def("__contains__",
+             [](const AssetMap &map, const string &name) {
+                 return map.contains(name);
+             })
+        .def("__len__", [](const AssetMap &map) { return map.size(); })
+        .def(
+            "__iter__",
+            [](const AssetMap &map) {
+                return py::make_key_iterator(map.begin(), map.end());
+            },
+            py::keep_alive<0, 1>())
+        .def(
+            "keys",
+            [](const AssetMap &map) {
+                return py::make_key_iterator(map.begin(), map.end());
+            },
+            py::keep_alive<0, 1>())
+        .def(
+            "values",
+            [](const AssetMap &map) {
+                return py::make_value_iterator(map.begin(), map.end());
+            },
+            py::keep_alive<0, 1>())
+        .def(
+            "items",
+            [](const AssetMap &map) {
+                return py::make_iterator(map.begin(), map.end());
+            },
+            py::keep_alive<0, 1>());
 
     // order
     py::enum_<OrderSizeType>(m, "OrderSizeType")
@@ -281,6 +646,78 @@ PYBIND11_MODULE(yabte_cpp_backtest, m) {
 
     py::bind_deque<OrderDeque>(m, "OrderDeque");
 
+    // strategy data window
+    py::class_<WindowColumn>(m, "WindowColumn")
+        .def("last", &WindowColumn::last<double>, py::arg("k") = 0)
+        .def("at", &WindowColumn::at<double>, py::arg("offset"));
+
+    // len() and the offsets of at/last count every visible row, columns,
+    // table and numpy hold only the rows from base (all of them except in
+    // run_stream) so their row i is offset base + i
+    py::class_<DataWindow, shared_ptr<DataWindow>>(m, "DataWindow")
+        .def("__len__", &DataWindow::size)
+        .def_property_readonly("base", &DataWindow::base)
+        .def("__getitem__",
+             [](const DataWindow &w, const string &name) {
+                 return py::reinterpret_steal<py::object>(
+                     arrow::py::wrap_chunked_array(w.array(name)));
+             })
+        .def("column",
+             py::overload_cast<const string &>(&DataWindow::column,
+                                               py::const_),
+             py::arg("name"), py::keep_alive<0, 1>())
+        .def(
+            "last",
+            [](const DataWindow &w, const string &name, const int64_t k) {
+                return w.column(name).last(k);
+            },
+            py::arg("name"), py::arg("k") = 0)
+        .def(
+            "at",
+            [](const DataWindow &w, const string &name, const int64_t offset) {
+                return w.column(name).at(offset);
+            },
+            py::arg("name"), py::arg("offset"))
+        .def_property_readonly("column_names",
+                               [](const DataWindow &w) {
+                                   return w.view_.table_->ColumnNames();
+                               })
+        .def_property_readonly("table",
+                               [](const DataWindow &w) {
+                                   return py::reinterpret_steal<py::object>(
+                                       arrow::py::wrap_table(w.table()));
+                               })
+        .def("numpy", &numpy_columns);
+
+    // executor
+    py::class_<yuc::Executor, shared_ptr<yuc::Executor>>(m, "Executor")
+        .def(py::init([](const unsigned num_threads, const bool pin_threads) {
+                 return make_shared<yuc::Executor>(yuc::ExecutorOptions{
+                     .num_threads = num_threads, .pin_threads = pin_threads});
+             }),
+             py::arg("num_threads") = 0, py::arg("pin_threads") = false)
+        .def_property_readonly("num_threads", &yuc::Executor::num_threads);
+
+    // indicator cache
+    py::class_<IndicatorCache::Stats>(m, "IndicatorCacheStats")
+        .def_readonly("hits", &IndicatorCache::Stats::hits)
+        .def_readonly("misses", &IndicatorCache::Stats::misses)
+        .def_readonly("entries", &IndicatorCache::Stats::entries);
+
+    py::class_<IndicatorCache, shared_ptr<IndicatorCache>>(m, "IndicatorCache")
+        .def(py::init<>())
+        .def(
+            "compute",
+            [](IndicatorCache &c, py::handle values, const string &function,
+               const vector<ParamValue> &params) {
+                return wrap_values(
+                    c.compute(unwrap_values(values), function, params));
+            },
+            py::arg("values"), py::arg("function"),
+            py::arg("params") = vector<ParamValue>{})
+        .def_property_readonly("stats", &IndicatorCache::stats)
+        .def("clear", &IndicatorCache::clear);
+
     // strategy
     py::class_<Strategy, PyStrategy, shared_ptr<Strategy>>(m, "Strategy")
         .def(py::init<>())
@@ -296,21 +733,89 @@ PYBIND11_MODULE(yabte_cpp_backtest, m) {
                  std::shared_ptr<arrow::Table> data_uw = status.ValueOrDie();
                  return s.extend_data(data_uw);
              })
+        .def("lookback", &Strategy::lookback)
+        .def("block_size", &Strategy::block_size)
         .def_property_readonly("data",
-                               [](const Strategy &s) -> py::handle {
-                                   return arrow::py::wrap_table(s.data_);
-                               })
+                               [](const Strategy &s) { return s.data_; })
         .def_property_readonly(
             "asset_map", [](const Strategy &s) { return s.asset_map_.get(); })
         .def_property_readonly(
             "orders", [](const Strategy &s) { return s.orders_.get(); })
+        .def_readonly("indicators", &Strategy::indicators_)
         .def_readonly("params", &Strategy::params_);
 
+    py::class_<ExprStrategy, Strategy, shared_ptr<ExprStrategy>>(
+        m, "ExprStrategy")
+        .def(py::init<const string &, const string &>(), py::arg("source"),
+             py::arg("asset"))
+        .def_readonly("source", &ExprStrategy::source_)
+        .def_readonly("asset_name", &ExprStrategy::asset_name_);
+
     // strategy runner
     py::bind_map<ParamMap>(m, "ParamMap");
 
+    // parameter search
+    py::class_<IntRange>(m, "IntRange")
+        .def(py::init<int, int, int>(), py::arg("low"), py::arg("high"),
+             py::arg("step") = 1)
+        .def_readwrite("low", &IntRange::low)
+        .def_readwrite("high", &IntRange::high)
+        .def_readwrite("step", &IntRange::step);
+
+    py::class_<DoubleRange>(m, "DoubleRange")
+        .def(py::init<double, double, bool>(), py::arg("low"), py::arg("high"),
+             py::arg("log") = false)
+        .def_readwrite("low", &DoubleRange::low)
+        .def_readwrite("high", &DoubleRange::high)
+        .def_readwrite("log", &DoubleRange::log);
+
+    py::class_<Choice>(m, "Choice")
+        .def(py::init<vector<ParamValue>>(), py::arg("values"))
+        .def_readwrite("values", &Choice::values);
+
+    py::enum_<SearchMethod>(m, "SearchMethod")
+        .value("RANDOM", SearchMethod::RANDOM)
+        .value("LATIN_HYPERCUBE", SearchMethod::LATIN_HYPERCUBE)
+        .value("TPE", SearchMethod::TPE);
+
+    py::class_<SearchOptions>(m, "SearchOptions")
+        .def(py::init<>())
+        .def_readwrite("method", &SearchOptions::method)
+        .def_readwrite("num_trials", &SearchOptions::num_trials)
+        .def_readwrite("seed", &SearchOptions::seed)
+        .def_readwrite("maximize", &SearchOptions::maximize)
+        .def_readwrite("max_parallelism", &SearchOptions::max_parallelism)
+        .def_readwrite("startup_trials", &SearchOptions::startup_trials)
+        .def_readwrite("gamma", &SearchOptions::gamma)
+        .def_readwrite("num_candidates", &SearchOptions::num_candidates);
+
+    py::class_<SearchResult>(m, "SearchResult")
+        .def_readonly("params", &SearchResult::params_)
+        .def_readonly("values", &SearchResult::values_)
+        .def_readonly("best", &SearchResult::best_)
+        .def(
+            "summary",
+            [](const SearchResult &r, const string &objective) {
+                return py::reinterpret_steal<py::object>(
+                    arrow::py::wrap_table(r.summary(objective)));
+            },
+            py::arg("objective") = "objective");
+
+    py::class_<ParamSearch>(m, "ParamSearch")
+        .def(py::init<const ParamSpace &, const SearchOptions &>(),
+             py::arg("space"), py::arg("options") = SearchOptions{})
+        .def("ask", &ParamSearch::ask)
+        .def("tell", &ParamSearch::tell)
+        .def("result", &ParamSearch::result);
+
+    py::class_<ArenaStats>(m, "ArenaStats")
+        .def_readonly("bytes", &ArenaStats::bytes)
+        .def_readonly("allocations", &ArenaStats::allocations);
+
     py::class_<StrategyRunnerResult>(m, "StrategyRunnerResult")
         .def(py::init<>())
+        .def_property_readonly("arena_stats",
+                               &StrategyRunnerResult::arena_stats)
         .def_property_readonly("orders_unprocessed",
                                [](const StrategyRunnerResult &srr) {
                                    return srr.orders_unprocessed_.get();
@@ -321,7 +826,64 @@ PYBIND11_MODULE(yabte_cpp_backtest, m) {
         .def_property_readonly(
             "book_history", [](const StrategyRunnerResult &srr) -> py::handle {
                 return arrow::py::wrap_table(srr.book_history());
-            });
+            })
+        .def(
+            "performance",
+            [](const StrategyRunnerResult &srr, const double periods_per_year,
+               const shared_ptr<yuc::Executor> &executor) {
+                return py::reinterpret_steal<py::object>(
+                    arrow::py::wrap_table(PerformanceTable(
+                        srr.books_, periods_per_year,
+                        executor ? *executor : yuc::Executor::shared())));
+            },
+            py::arg("periods_per_year") = 252.,
+            py::arg("executor") = nullptr);
+
+    // performance of each book of a batch's results, on executor (e.g. the
+    // runner's) or the shared one
+    m.def(
+        "performance_table",
+        [](const vector<StrategyRunnerResult> &results,
+           const double periods_per_year,
+           const shared_ptr<yuc::Executor> &executor) {
+            return py::reinterpret_steal<py::object>(
+                arrow::py::wrap_table(PerformanceTable(
+                    results, periods_per_year,
+                    executor ? *executor : yuc::Executor::shared())));
+        },
+        py::arg("results"), py::arg("periods_per_year") = 252.,
+        py::arg("executor") = nullptr);
+
+    py::enum_<SignalKind>(m, "SignalKind")
+        .value("TARGET_POSITION", SignalKind::TARGET_POSITION)
+        .value("ORDER_SIZE", SignalKind::ORDER_SIZE);
+
+    py::class_<SignalOptions>(m, "SignalOptions")
+        .def(py::init<>())
+        .def_readwrite("kind", &SignalOptions::kind)
+        .def_readwrite("field", &SignalOptions::field)
+        .def_readwrite("book_name", &SignalOptions::book_name);
+
+    py::class_<HalvingOptions>(m, "HalvingOptions")
+        .def(py::init<>())
+        .def_readwrite("min_fraction", &HalvingOptions::min_fraction)
+        .def_readwrite("eta", &HalvingOptions::eta)
+        .def_readwrite("maximize", &HalvingOptions::maximize)
+        .def_readwrite("max_parallelism", &HalvingOptions::max_parallelism);
+
+    py::class_<HalvingResult>(m, "HalvingResult")
+        .def_readonly("params", &HalvingResult::params_)
+        .def_readonly("values", &HalvingResult::values_)
+        .def_readonly("rows", &HalvingResult::rows_)
+        .def_readonly("finalists", &HalvingResult::finalists_)
+        .def_readonly("results", &HalvingResult::results_)
+        .def(
+            "summary",
+            [](const HalvingResult &r, const string &objective) {
+                return py::reinterpret_steal<py::object>(
+                    arrow::py::wrap_table(r.summary(objective)));
+            },
+            py::arg("objective") = "objective");
 
     py::class_<StrategyRunner>(m, "StrategyRunner")
         .def(py::init([](pybind11::object py_table, const AssetVector &assets,
@@ -337,9 +899,92 @@ PYBIND11_MODULE(yabte_cpp_backtest, m) {
 
             return new StrategyRunner(data, assets, strategies, books);
         }))
+        .def_readwrite("indicator_cache", &StrategyRunner::indicator_cache_)
+        .def_readwrite("executor", &StrategyRunner::executor_)
         .def("run", &StrategyRunner::run)
+        .def(
+            "run_stream",
+            [](StrategyRunner &sr, pybind11::object py_reader,
+               const ParamMap &params) {
+                // any object exporting an arrow stream, e.g. a
+                // pyarrow.RecordBatchReader or a dataset scanner's reader
+                struct ArrowArrayStream stream;
+                py_reader.attr("_export_to_c")(
+                    reinterpret_cast<uintptr_t>(&stream));
+                auto status = arrow::ImportRecordBatchReader(&stream);
+
+                if (!status.ok()) {
+                    throw std::runtime_error(
+                        "Error converting pyarrow reader to arrow reader");
+                }
+                return sr.run_stream(status.ValueOrDie(), params);
+            },
+            py::arg("reader"), py::arg("params") = ParamMap{})
         .def("run_batch", &StrategyRunner::run_batch,
              py::call_guard<py::gil_scoped_release>())
+        .def("run_signals", &StrategyRunner::run_signals,
+             py::arg("params") = ParamMap{},
+             py::arg("options") = SignalOptions{},
+             py::call_guard<py::gil_scoped_release>())
+        .def(
+            "run_batch_summary",
+            [](StrategyRunner &sr, const vector<ParamMap> &params_vector,
+               const optional<vector<py::object>> &metric_specs,
+               const optional<unsigned int> num_threads) {
+                // python metrics take the gil back for each call
+                auto metrics = py_metrics(metric_specs);
+                shared_ptr<Table> table;
+                {
+                    py::gil_scoped_release release;
+                    table = sr.run_batch_summary(params_vector, metrics,
+                                                 num_threads);
+                }
+                return py::reinterpret_steal<py::object>(
+                    arrow::py::wrap_table(table));
+            },
+            py::arg("params_vector"), py::arg("metrics") = nullopt,
+            py::arg("num_threads") = nullopt)
+        .def(
+            "run_batch_summary_processes",
+            [](StrategyRunner &sr, const vector<ParamMap> &params_vector,
+               const optional<vector<py::object>> &metric_specs,
+               const optional<unsigned int> num_processes) {
+                // as run_batch_summary, each child calls its own copy of
+                // python metrics
+                auto metrics = py_metrics(metric_specs);
+                shared_ptr<Table> table;
+                {
+                    // taken back around each fork
+                    py::gil_scoped_release release;
+                    table = sr.run_batch_summary_processes(
+                        params_vector, metrics, num_processes);
+                }
+                return py::reinterpret_steal<py::object>(
+                    arrow::py::wrap_table(table));
+            },
+            py::arg("params_vector"), py::arg("metrics") = nullopt,
+            py::arg("num_processes") = nullopt)
+        .def(
+            "run_search",
+            [](StrategyRunner &sr, const ParamSpace &space,
+               const py::object &metric, const SearchOptions &options) {
+                auto objective = std::get<1>(py_named_metric(metric));
+                py::gil_scoped_release release;
+                return sr.run_search(space, objective, options);
+            },
+            py::arg("space"), py::arg("metric") = py::str("sharpe_ratio"),
+            py::arg("options") = SearchOptions{})
+        .def(
+            "run_halving",
+            [](StrategyRunner &sr, const vector<ParamMap> &params_vector,
+               const py::object &metric, const HalvingOptions &options) {
+                auto objective = std::get<1>(py_named_metric(metric));
+                py::gil_scoped_release release;
+                return sr.run_halving(params_vector, objective, options);
+            },
+            py::arg("params_vector"),
+            py::arg("metric") = py::str("sharpe_ratio"),
+            py::arg("options") = HalvingOptions{})
         // .def("run_batch",
         //      [](StrategyRunner &sr, pybind11::iterable py_iterable) {
         //          auto temp = py_iterable.cast<ParamMap>();
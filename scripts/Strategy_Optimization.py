@@ -167,8 +167,10 @@ class SMAXO_YBTCPP(ybt_cpp.Strategy):
             key_long = f"('{symbol}', 'CloseSMALong')"
             key_short = f"('{symbol}', 'CloseSMAShort')"
 
-            close_sma_short = self.data[key_short].slice(L - 2, 2).to_pandas()
-            close_sma_long = self.data[key_long].slice(L - 2, 2).to_pandas()
+            # columns hold the rows from self.data.base
+            i = L - self.data.base - 2
+            close_sma_short = self.data[key_short].slice(i, 2).to_pandas()
+            close_sma_long = self.data[key_long].slice(i, 2).to_pandas()
 
             if crossover(close_sma_short, close_sma_long):
                 self.orders.append(ybt_cpp.SimpleOrder(asset_name=symbol, size=-100))
@@ -3,7 +3,6 @@ import sys
 sys.path.append("/home/blair/projects/yabte_cpp/build/debug/pybind")
 
 
-import pandas as pd
 import pyarrow as pa
 import pyarrow.parquet as pq
 from yabte.tests._helpers import generate_nasdaq_dataset
@@ -47,29 +46,31 @@ class SMAXO(Strategy):
         return cloned
 
     def extend_data(self, data):
-        # enhance data with simple moving averages
-
-        df = data.to_pandas()
+        # enhance data with simple moving averages, computed on the arrow
+        # columns directly without a pandas round trip
 
         p = self.params
         days_short = p["days_short"]
         days_long = p["days_long"]
 
-        close_sma_short = (
-            df.loc[:, (slice(None), "Close")]
-            .rolling(days_short)
-            .mean()
-            .rename({"Close": "CloseSMAShort"}, axis=1, level=1)
-        )
-        close_sma_long = (
-            df.loc[:, (slice(None), "Close")]
-            .rolling(days_long)
-            .mean()
-            .rename({"Close": "CloseSMALong"}, axis=1, level=1)
-        )
-        new_df = pd.concat([close_sma_short, close_sma_long], axis=1).sort_index(axis=1)
-
-        return pa.Table.from_pandas(new_df)
+        names, columns = [], []
+        for name in sorted(data.column_names):
+            if not name.endswith(", 'Close')"):
+                continue
+            prefix = name[: -len(", 'Close')")]
+            for field, days in [
+                ("CloseSMALong", days_long),
+                ("CloseSMAShort", days_short),
+            ]:
+                names.append(f"{prefix}, '{field}')")
+                # cached across the parameter sets of a batch
+                columns.append(
+                    self.indicators.compute(
+                        data[name], "yabte_rolling_mean", [days]
+                    )
+                )
+
+        return pa.table(columns, names=names)
 
     def init(self): ...
 
@@ -89,8 +90,10 @@ class SMAXO(Strategy):
             key_long = f"('{symbol}', 'CloseSMALong')"
             key_short = f"('{symbol}', 'CloseSMAShort')"
 
-            close_sma_short = self.data[key_short].slice(L - 2, 2).to_pandas()
-            close_sma_long = self.data[key_long].slice(L - 2, 2).to_pandas()
+            # columns hold the rows from self.data.base
+            i = L - self.data.base - 2
+            close_sma_short = self.data[key_short].slice(i, 2).to_pandas()
+            close_sma_long = self.data[key_long].slice(i, 2).to_pandas()
 
             if crossover(close_sma_short, close_sma_long):
                 self.orders.append(SimpleOrder(asset_name=symbol, size=-100))
@@ -0,0 +1,265 @@
+#include "YABTE/BackTest/Analytics.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <string>
+
+#include "YABTE/BackTest/StrategyRunner.hpp"
+#include "YABTE/Utilities/Concurrency/Executor.hpp"
+
+using std::string;
+
+using YABTE::Utilities::Concurrency::Executor;
+
+using arrow::Status;
+
+namespace YABTE::BackTest {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// sum of f(0) .. f(n - 1). independent accumulators break the add
+// dependency chain so the compiler can keep them in vector registers.
+template <typename F>
+double accumulate(const int64_t n, F f) {
+    constexpr int64_t K = 4;
+    double acc[K] = {0., 0., 0., 0.};
+    int64_t i = 0;
+    for (; i + K <= n; i += K) {
+        for (int64_t k = 0; k < K; ++k) acc[k] += f(i + k);
+    }
+    double tail = 0.;
+    for (; i < n; ++i) tail += f(i);
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]) + tail;
+}
+
+// contiguous values of a float64 column
+Result<const double *> float64_values(const shared_ptr<Table> &table,
+                                      const string &name) {
+    auto column = table->GetColumnByName(name);
+    if (!column) {
+        return Status::KeyError("Column not found: ", name);
+    }
+    if (column->type()->id() != arrow::Type::DOUBLE ||
+        column->null_count() != 0 || column->num_chunks() != 1) {
+        return Status::TypeError("Expected a single chunk float64 column: ",
+                                 name);
+    }
+    return static_cast<const arrow::DoubleArray &>(*column->chunk(0))
+        .raw_values();
+}
+
+double traded_notional(const Book &book) {
+    double notional = 0.;
+    auto &ledger = book.ledger_;
+    for (int64_t i = 0; i < ledger.size(); ++i) {
+        if (ledger.kind(i) == TransactionKind::TRADE)
+            notional += std::abs(ledger.quantity(i) * ledger.price(i));
+    }
+    return notional;
+}
+
+// ComputePerformance of each book on the executor
+vector<PerformanceStats> compute_all(const vector<const Book *> &books,
+                                     const double periods_per_year,
+                                     Executor &executor) {
+    vector<PerformanceStats> stats(books.size());
+    executor.parallel_for(0, books.size(), [&](int64_t i) {
+        stats[i] = ComputePerformance(*books[i], periods_per_year);
+    });
+    return stats;
+}
+
+// stats as columns, in PerformanceStats order
+class StatsBuilder {
+   public:
+    void append(const PerformanceStats &s) {
+        CHECK(num_days_.Append(s.num_days).ok());
+        double values[] = {s.total_return,      s.annual_return,
+                           s.annual_volatility, s.sharpe_ratio,
+                           s.sortino_ratio,     s.max_drawdown};
+        for (size_t k = 0; k < std::size(values); ++k)
+            CHECK(doubles_[k].Append(values[k]).ok());
+        CHECK(duration_.Append(s.max_drawdown_duration).ok());
+        CHECK(doubles_[6].Append(s.calmar_ratio).ok());
+        CHECK(doubles_[7].Append(s.turnover).ok());
+        CHECK(doubles_[8].Append(s.exposure).ok());
+    }
+
+    void finish(arrow::FieldVector &fields, arrow::ArrayVector &columns) {
+        auto add = [&](const string &name, arrow::ArrayBuilder &builder) {
+            auto st_a = builder.Finish();
+            CHECK(st_a.ok()) << "Error: " << st_a.status();
+            fields.push_back(arrow::field(name, builder.type()));
+            columns.push_back(st_a.ValueOrDie());
+        };
+        add("num_days", num_days_);
+        const char *names[] = {"total_return",      "annual_return",
+                               "annual_volatility", "sharpe_ratio",
+                               "sortino_ratio",     "max_drawdown"};
+        for (size_t k = 0; k < std::size(names); ++k)
+            add(names[k], doubles_[k]);
+        add("max_drawdown_duration", duration_);
+        add("calmar_ratio", doubles_[6]);
+        add("turnover", doubles_[7]);
+        add("exposure", doubles_[8]);
+    }
+
+   private:
+    arrow::Int64Builder num_days_;
+    arrow::DoubleBuilder doubles_[9];
+    arrow::Int64Builder duration_;
+};
+
+}  // namespace
+
+PerformanceStats ComputePerformance(const double *total, const double *mtm,
+                                    const int64_t n,
+                                    const double traded_notional,
+                                    const double periods_per_year) {
+    PerformanceStats s;
+    s.num_days = n;
+    s.total_return = s.annual_return = s.annual_volatility = kNaN;
+    s.sharpe_ratio = s.sortino_ratio = s.calmar_ratio = kNaN;
+    s.turnover = s.exposure = kNaN;
+    s.max_drawdown = 0.;
+    s.max_drawdown_duration = 0;
+    if (n == 0) return s;
+
+    auto mean_total = accumulate(n, [&](int64_t i) { return total[i]; }) / n;
+    s.turnover = traded_notional / mean_total;
+    if (mtm) {
+        s.exposure = accumulate(n, [&](int64_t i) {
+                         return std::abs(mtm[i]) / total[i];
+                     }) /
+                     n;
+    }
+
+    // running peak is inherently sequential
+    double peak = total[0];
+    int64_t below = 0;
+    for (int64_t i = 1; i < n; ++i) {
+        if (total[i] >= peak) {
+            peak = total[i];
+            below = 0;
+            continue;
+        }
+        s.max_drawdown_duration = std::max(s.max_drawdown_duration, ++below);
+        if (peak > 0) {
+            s.max_drawdown =
+                std::max(s.max_drawdown, (peak - total[i]) / peak);
+        }
+    }
+
+    auto m = n - 1;  // number of returns
+    if (m == 0) return s;
+
+    auto growth = total[n - 1] / total[0];
+    s.total_return = growth - 1;
+    s.annual_return = std::pow(growth, periods_per_year / m) - 1;
+    if (s.max_drawdown > 0) s.calmar_ratio = s.annual_return / s.max_drawdown;
+
+    auto ret = [&](int64_t i) { return total[i + 1] / total[i] - 1; };
+    auto mean = accumulate(m, ret) / m;
+    auto downside = std::sqrt(accumulate(m, [&](int64_t i) {
+                                  auto r = std::min(ret(i), 0.);
+                                  return r * r;
+                              }) /
+                              m);
+    auto annualise = std::sqrt(periods_per_year);
+    if (downside > 0) s.sortino_ratio = mean / downside * annualise;
+
+    if (m < 2) return s;
+    auto sd = std::sqrt(accumulate(m,
+                                   [&](int64_t i) {
+                                       auto d = ret(i) - mean;
+                                       return d * d;
+                                   }) /
+                        (m - 1));
+    s.annual_volatility = sd * annualise;
+    if (sd > 0) s.sharpe_ratio = mean / sd * annualise;
+    return s;
+}
+
+Result<PerformanceStats> ComputePerformance(const shared_ptr<Table> &history,
+                                            const double traded_notional,
+                                            const double periods_per_year) {
+    ARROW_ASSIGN_OR_RAISE(auto combined, history->CombineChunks());
+    if (combined->num_rows() == 0) {
+        return ComputePerformance(nullptr, nullptr, 0, traded_notional,
+                                  periods_per_year);
+    }
+    ARROW_ASSIGN_OR_RAISE(auto total, float64_values(combined, "total"));
+    ARROW_ASSIGN_OR_RAISE(auto mtm, float64_values(combined, "mtm"));
+    return ComputePerformance(total, mtm, combined->num_rows(),
+                              traded_notional, periods_per_year);
+}
+
+PerformanceStats ComputePerformance(const Book &book,
+                                    const double periods_per_year) {
+    auto n = book._history_.size();
+    vector<double> total(n), mtm(n);
+    for (size_t d = 0; d < n; ++d) {
+        mtm[d] = std::get<2>(book._history_[d]);
+        total[d] = std::get<3>(book._history_[d]);
+    }
+    return ComputePerformance(total.data(), mtm.data(), n,
+                              traded_notional(book), periods_per_year);
+}
+
+shared_ptr<Table> PerformanceTable(const BookVector &books,
+                                   const double periods_per_year,
+                                   Executor &executor) {
+    vector<const Book *> all;
+    for (auto &book : books) all.push_back(book.get());
+    auto computed = compute_all(all, periods_per_year, executor);
+
+    arrow::StringBuilder names;
+    StatsBuilder stats;
+    for (size_t i = 0; i < all.size(); ++i) {
+        CHECK(names.Append(all[i]->name_).ok());
+        stats.append(computed[i]);
+    }
+
+    arrow::FieldVector fields{arrow::field("book", arrow::utf8())};
+    arrow::ArrayVector columns{names.Finish().ValueOrDie()};
+    stats.finish(fields, columns);
+    return Table::Make(arrow::schema(fields), columns,
+                       static_cast<int64_t>(books.size()));
+}
+
+shared_ptr<Table> PerformanceTable(const vector<StrategyRunnerResult> &results,
+                                   const double periods_per_year,
+                                   Executor &executor) {
+    vector<const Book *> all;
+    arrow::Int64Builder runs;
+    for (size_t r = 0; r < results.size(); ++r) {
+        for (auto &book : results[r].books_) {
+            CHECK(runs.Append(r).ok());
+            all.push_back(book.get());
+        }
+    }
+    auto computed = compute_all(all, periods_per_year, executor);
+
+    arrow::StringBuilder names;
+    StatsBuilder stats;
+    for (size_t i = 0; i < all.size(); ++i) {
+        CHECK(names.Append(all[i]->name_).ok());
+        stats.append(computed[i]);
+    }
+    auto num_rows = static_cast<int64_t>(all.size());
+
+    arrow::FieldVector fields{arrow::field("run", arrow::int64()),
+                              arrow::field("book", arrow::utf8())};
+    arrow::ArrayVector columns{runs.Finish().ValueOrDie(),
+                               names.Finish().ValueOrDie()};
+    stats.finish(fields, columns);
+    return Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+}  // namespace YABTE::BackTest
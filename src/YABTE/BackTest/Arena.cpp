@@ -0,0 +1,26 @@
+#include "YABTE/BackTest/Arena.hpp"
+
+namespace YABTE::BackTest {
+
+thread_local shared_ptr<RunArena> RunArena::current_;
+
+RunArena::RunArena(const size_t initial_size,
+                   std::pmr::memory_resource *upstream)
+    : buffer_(initial_size, upstream) {}
+
+const shared_ptr<RunArena> &RunArena::current() { return current_; }
+
+void *RunArena::do_allocate(size_t bytes, size_t alignment) {
+    this->stats_.bytes += bytes;
+    ++this->stats_.allocations;
+    return this->buffer_.allocate(bytes, alignment);
+}
+
+ArenaScope::ArenaScope(const shared_ptr<RunArena> &arena)
+    : previous_(RunArena::current_) {
+    RunArena::current_ = arena;
+}
+
+ArenaScope::~ArenaScope() { RunArena::current_ = this->previous_; }
+
+}  // namespace YABTE::BackTest
@@ -2,10 +2,10 @@
 
 #include <arrow/table.h>
 
-#include <regex>
+#include <cmath>
 #include <stdexcept>
 
-using std::dynamic_pointer_cast, std::make_shared;
+using std::make_shared;
 
 namespace YABTE::BackTest {
 
@@ -22,6 +22,20 @@ Asset::Asset(const string &name, const string &denom, const int price_round_dp,
     }
 }
 
+AssetMap::AssetMap() : symbols_(make_shared<SymbolTable>()) {}
+
+AssetMap::AssetMap(const shared_ptr<SymbolTable> &symbols)
+    : symbols_(symbols) {}
+
+void AssetMap::add(const shared_ptr<Asset> &asset) {
+    auto id = this->symbols_->intern(asset->name_);
+    asset->id_ = id;
+    this->insert_or_assign(asset->name_, asset);
+    if (static_cast<size_t>(id) >= this->by_id_.size())
+        this->by_id_.resize(id + 1);
+    this->by_id_[id] = asset;
+}
+
 double Asset::round_quantity(const double &quantity) const {
     return round_n_digits(quantity, this->quantity_round_dp_);
 }
@@ -33,9 +47,28 @@ vector<string> Asset::_get_fields(const AssetDataFieldInfo &field_info) const {
     return res;
 }
 
-arrow::Status _FilterTable(const DayData &day_data, vector<int> &indices,
+AssetColumns Asset::_resolve_columns(const ColumnPlan &plan) const {
+    AssetColumns columns;
+    for (auto const &[fn, fi] : this->data_fields()) {
+        auto col = plan.find(this->data_label_, fn);
+        if (!col.resolved() && (fi & AssetDataFieldInfo::REQUIRED)) {
+            throw std::runtime_error("Required field " + fn +
+                                     " not found for asset " + this->name_);
+        }
+        columns.fields_.push_back(fn);
+        columns.columns_.push_back(col);
+    }
+    return columns;
+}
+
+double Asset::_field_value(const DayView &day_data, const size_t field) const {
+    if (field >= this->columns_.size()) return std::nan("");
+    return day_data.value(this->columns_[field]);
+}
+
+arrow::Status _FilterTable(const arrow::Table &day_data, vector<int> &indices,
                            vector<string> &new_names,
-                           shared_ptr<DayData> &day_data_filt) {
+                           shared_ptr<arrow::Table> &day_data_filt) {
     ARROW_ASSIGN_OR_RAISE(auto x, day_data.SelectColumns(indices));
     ARROW_ASSIGN_OR_RAISE(auto y, x->RenameColumns(new_names));
 
@@ -45,25 +78,26 @@ arrow::Status _FilterTable(const DayData &day_data, vector<int> &indices,
     return arrow::Status::OK();
 }
 
-shared_ptr<DayData> Asset::_filter_data(const DayData &day_data) const {
-    const std::regex field_re(R"(^\('(\S+)', '(\S+)'\)$)");
+shared_ptr<arrow::Table> Asset::_filter_data(const DayView &day_data) const {
+    auto day_table = day_data.to_table();
+
+    // outside of a run the columns may not be resolved yet
+    auto columns = this->columns_;
+    if (columns.empty()) {
+        columns = this->_resolve_columns(ColumnPlan(day_table->schema()));
+    }
 
     vector<int> indices;
     vector<string> new_names;
-
-    for (auto const &cn : day_data.ColumnNames()) {
-        const vector<std::smatch> matches{
-            std::sregex_iterator{cn.begin(), cn.end(), field_re},
-            std::sregex_iterator{}};
-
-        if (matches.size() > 0 && matches[0].str(1) == this->data_label_) {
-            indices.push_back(day_data.schema()->GetFieldIndex(cn));
-            new_names.push_back(matches[0].str(2));
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i].resolved()) {
+            indices.push_back(columns[i].index);
+            new_names.push_back(columns.fields_[i]);
         }
     }
 
-    auto day_data_filt = day_data.Slice(0, 1);
-    auto st = _FilterTable(day_data, indices, new_names, day_data_filt);
+    shared_ptr<arrow::Table> day_data_filt;
+    auto st = _FilterTable(*day_table, indices, new_names, day_data_filt);
     if (!st.ok()) {
         throw std::runtime_error("Error: " + st.ToString());
     }
@@ -79,49 +113,28 @@ shared_ptr<Asset> OHLCAsset::clone() const {
     return make_shared<OHLCAsset>(*this);
 };
 
-double OHLCAsset::intraday_traded_price(const DayData &asset_day_data,
+double OHLCAsset::intraday_traded_price(const DayView &day_data,
                                         const optional<double> size) const {
-    auto s_low = asset_day_data.GetColumnByName("Low");
-    auto s_high = asset_day_data.GetColumnByName("High");
-    auto st_s_low = s_low->GetScalar(0);
-    auto st_s_high = s_high->GetScalar(0);
-
-    if (st_s_low.ok() && st_s_high.ok()) {
-        auto low =
-            dynamic_pointer_cast<arrow::DoubleScalar>(st_s_low.ValueOrDie())
-                ->value;
-        auto high =
-            dynamic_pointer_cast<arrow::DoubleScalar>(st_s_high.ValueOrDie())
-                ->value;
-
-        if (!std::isnan(low) && !std::isnan(high)) {
-            return round_n_digits((low + high) / 2, this->price_round_dp_);
-        }
-    }
-
-    auto s_close = asset_day_data.GetColumnByName("Close");
-    auto st_s_close = s_close->GetScalar(0);
+    auto low = this->_field_value(day_data, Field::LOW);
+    auto high = this->_field_value(day_data, Field::HIGH);
 
-    if (st_s_close.ok()) {
-        auto close =
-            dynamic_pointer_cast<arrow::DoubleScalar>(st_s_close.ValueOrDie())
-                ->value;
+    if (!std::isnan(low) && !std::isnan(high)) {
+        return round_n_digits((low + high) / 2, this->price_round_dp_);
+    }
 
+    if (this->columns_.size() > Field::CLOSE &&
+        this->columns_[Field::CLOSE].resolved()) {
+        auto close = this->_field_value(day_data, Field::CLOSE);
         return round_n_digits(close, this->price_round_dp_);
     }
 
     throw std::runtime_error("Unable to determine intraday traded price");
 }
 
-double OHLCAsset::end_of_day_price(const DayData &asset_day_data) const {
-    auto s_close = asset_day_data.GetColumnByName("Close");
-    auto st_s_close = s_close->GetScalar(0);
-
-    if (st_s_close.ok()) {
-        auto close =
-            dynamic_pointer_cast<arrow::DoubleScalar>(st_s_close.ValueOrDie())
-                ->value;
-
+double OHLCAsset::end_of_day_price(const DayView &day_data) const {
+    if (this->columns_.size() > Field::CLOSE &&
+        this->columns_[Field::CLOSE].resolved()) {
+        auto close = this->_field_value(day_data, Field::CLOSE);
         return round_n_digits(close, this->price_round_dp_);
     }
 
@@ -2,6 +2,7 @@
 
 #include <arrow/stl.h>
 
+#include <algorithm>
 #include <cmath>
 
 #include "YABTE/Utilities/Arrow/TableHelpers.hpp"
@@ -16,7 +17,8 @@ Book::Book(const string& name, const string& denom, double cash, double rate,
       denom_(denom),
       cash_(cash),
       rate_(rate),
-      interest_round_dp_(interest_round_dp) {}
+      interest_round_dp_(interest_round_dp),
+      symbols_(make_shared<SymbolTable>()) {}
 
 shared_ptr<Book> Book::clone() const { return make_shared<Book>(*this); }
 
@@ -33,25 +35,55 @@ bool Book::test_trades(const vector<shared_ptr<Trade>>& trades) const {
     return true;
 }
 
+bool Book::test_fill(const AssetId id, const double quantity) const {
+    // TODO: check the mandate of the asset, as test_trades would
+    return true;
+}
+
 void Book::add_transactions(const TransactionVector& transactions) {
     for (auto& tran : transactions) {
         if (auto trade = dynamic_cast<const Trade*>(tran.get());
             trade != nullptr) {
-            this->positions_[trade->asset_name_] += trade->quantity_;
-            this->cash_ += trade->total_;
+            this->_add_trade(*trade);
         } else if (auto ctran =
                        dynamic_cast<const CashTransaction*>(tran.get());
                    ctran != nullptr) {
-            this->cash_ += ctran->total_;
+            this->add_cash(ctran->ts_, ctran->total_, ctran->desc_);
         } else {
             throw std::runtime_error("Unsupport transaction class");
         }
-
-        this->transactions_.push_back(tran);
     }
 }
 
-void Book::eod_tasks(const Timestamp& ts, const DayData& day_data,
+void Book::add_trades(const vector<shared_ptr<Trade>>& trades) {
+    for (auto& trade : trades) this->_add_trade(*trade);
+}
+
+void Book::add_cash(const Timestamp& ts, const double total,
+                    const string& desc) {
+    this->cash_ += total;
+    this->ledger_.append_cash(ts, total, desc);
+}
+
+void Book::_add_trade(const Trade& trade) {
+    // trades from orders carry the run's id, others are looked up
+    auto id = trade.asset_id_ != NO_ASSET_ID
+                  ? trade.asset_id_
+                  : this->_asset_id(trade.asset_name_);
+    this->_add_fill(trade.ts_, id, trade.quantity_, trade.price_,
+                    trade.total_, trade.order_label_);
+}
+
+void Book::_add_fill(const Timestamp& ts, const AssetId id,
+                     const double quantity, const double price,
+                     const double total, const optional<string>& label) {
+    this->_position(id) += quantity;
+    this->cash_ += total;
+    this->ledger_.append(ts, TransactionKind::TRADE, id, quantity, price,
+                         total, label);
+}
+
+void Book::eod_tasks(const Timestamp& ts, const DayView& day_data,
                      const AssetMap& asset_map) {
     // Run end of day tasks such as book keeping."""
     // accumulate continously compounded interest
@@ -59,16 +91,18 @@ void Book::eod_tasks(const Timestamp& ts, const DayData& day_data,
     auto interest = round_n_digits(this->cash_ * (std::exp(this->rate_) - 1),
                                    this->interest_round_dp_);
     if (this->rate_ != 0 && interest != 0) {
-        auto cash_trans = CashTransaction(
-            ts, interest, "interest payment on cash {self.cash:.2f}"s);
-        const TransactionVector trans = {make_shared<Transaction>(cash_trans)};
-        this->add_transactions(trans);
+        this->add_cash(ts, interest,
+                       "interest payment on cash {self.cash:.2f}"s);
     }
 
     auto mtm = 0.0;
-    for (const auto& [an, q] : this->positions_) {
-        if (auto asset = asset_map.at(an); asset != nullptr) {
-            mtm += asset->end_of_day_price(*asset->_filter_data(day_data)) * q;
+    // positions the book started with may be in assets the run lacks
+    auto priced = std::min(this->positions_.size(), asset_map.by_id_.size());
+    for (size_t id = 0; id < priced; ++id) {
+        if (!this->held_[id]) continue;
+        if (auto& asset = asset_map.at(static_cast<AssetId>(id));
+            asset != nullptr) {
+            mtm += asset->end_of_day_price(day_data) * this->positions_[id];
         }
     }
 
@@ -84,6 +118,52 @@ void Book::eod_tasks(const Timestamp& ts, const DayData& day_data,
     // self._history.append([ts, cash, mtm, cash + mtm])
 }
 
+map<string, double> Book::positions() const {
+    map<string, double> positions;
+    for (size_t id = 0; id < this->positions_.size(); ++id) {
+        if (this->held_[id])
+            positions.emplace(this->symbols_->name(static_cast<AssetId>(id)),
+                              this->positions_[id]);
+    }
+    return positions;
+}
+
+void Book::set_position(const string& asset_name, const double quantity) {
+    this->_position(this->_asset_id(asset_name)) = quantity;
+}
+
+AssetId Book::_asset_id(const string& asset_name) {
+    return this->symbols_bound_ ? this->symbols_->id(asset_name)
+                                : this->symbols_->intern(asset_name);
+}
+
+double& Book::_position(const AssetId id) {
+    if (static_cast<size_t>(id) >= this->positions_.size()) {
+        this->positions_.resize(id + 1, 0.);
+        this->held_.resize(id + 1, 0);
+    }
+    this->held_[id] = 1;
+    return this->positions_[id];
+}
+
+void Book::_bind_symbols(const shared_ptr<SymbolTable>& symbols) {
+    auto positions = this->positions();
+    this->symbols_ = symbols;
+    this->symbols_bound_ = false;
+    this->positions_.assign(symbols->size(), 0.);
+    this->held_.assign(symbols->size(), 0);
+    for (auto& [name, q] : positions) this->set_position(name, q);
+    this->symbols_bound_ = true;
+}
+
+TransactionVector Book::transactions() const {
+    return this->ledger_.transactions(*this->symbols_);
+}
+
+shared_ptr<Table> Book::ledger() const {
+    return this->ledger_.to_table(*this->symbols_);
+}
+
 shared_ptr<Table> Book::history() const {
     shared_ptr<Table> table;
     vector<std::string> names = {"ts", "cash", "mtm", "total"};
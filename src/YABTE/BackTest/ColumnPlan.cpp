@@ -0,0 +1,37 @@
+#include "YABTE/BackTest/ColumnPlan.hpp"
+
+#include <algorithm>
+
+#include "YABTE/Utilities/Arrow/TableHelpers.hpp"
+
+using YABTE::Utilities::Arrow::ParseColumnName;
+
+namespace YABTE::BackTest {
+
+int AssetColumns::find(const string &field) const {
+    auto it = std::find(this->fields_.begin(), this->fields_.end(), field);
+    if (it == this->fields_.end()) return -1;
+    return static_cast<int>(it - this->fields_.begin());
+}
+
+ColumnPlan::ColumnPlan(const shared_ptr<arrow::Schema> &schema) {
+    for (int i = 0; i < schema->num_fields(); ++i) {
+        auto &field = schema->field(i);
+        if (auto parsed = ParseColumnName(field->name())) {
+            auto &[label, fn] = *parsed;
+            this->columns_[label].emplace(fn,
+                                          FieldColumn{i, field->type()->id()});
+        }
+    }
+}
+
+FieldColumn ColumnPlan::find(const string &data_label,
+                             const string &field) const {
+    auto it_label = this->columns_.find(data_label);
+    if (it_label == this->columns_.end()) return {};
+    auto it_field = it_label->second.find(field);
+    if (it_field == it_label->second.end()) return {};
+    return it_field->second;
+}
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,599 @@
+#include "YABTE/BackTest/ExprStrategy.hpp"
+
+#include <arrow/compute/api.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <format>
+#include <map>
+#include <stdexcept>
+
+#include "YABTE/BackTest/Order.hpp"
+#include "YABTE/Utilities/Arrow/ComputeFunctions.hpp"
+
+using arrow::Datum;
+using std::make_shared;
+
+using YABTE::Utilities::Arrow::RegisterComputeFunctions;
+
+namespace YABTE::BackTest {
+
+namespace {
+
+using Kind = ExprNode::Kind;
+
+// rolling kernels taking a column and an integer window
+const map<string, string> kWindowFunctions{
+    {"sma", "yabte_rolling_mean"}, {"sum", "yabte_rolling_sum"},
+    {"min", "yabte_rolling_min"},  {"max", "yabte_rolling_max"},
+    {"std", "yabte_rolling_std"},  {"var", "yabte_rolling_var"},
+    {"zscore", "yabte_rolling_zscore"}, {"rank", "yabte_rolling_rank"}};
+
+const map<string, string> kOperators{
+    {"+", "add"},         {"-", "subtract"},      {"*", "multiply"},
+    {"/", "divide"},      {"<", "less"},          {"<=", "less_equal"},
+    {">", "greater"},     {">=", "greater_equal"}, {"==", "equal"},
+    {"!=", "not_equal"},  {"and", "and_kleene"},  {"or", "or_kleene"}};
+
+[[noreturn]] void syntax_error(const string &what, const size_t pos) {
+    throw std::invalid_argument("Rule syntax error at " + std::to_string(pos) +
+                                ": " + what);
+}
+
+struct Token {
+    enum class Kind { NUMBER, NAME, SYMBOL, SEPARATOR, END };
+    Kind kind;
+    string text;
+    double number = 0.;
+    size_t pos = 0;
+};
+
+// new lines inside parentheses don't separate rules
+vector<Token> tokenize(const string &source) {
+    vector<Token> tokens;
+    int depth = 0;
+    size_t i = 0;
+    while (i < source.size()) {
+        auto c = source[i];
+        if (c == '#') {
+            while (i < source.size() && source[i] != '\n') ++i;
+        } else if (c == ';' || (c == '\n' && depth == 0)) {
+            tokens.push_back({Token::Kind::SEPARATOR, string(1, c), 0., i++});
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            size_t end = 0;
+            double number = 0.;
+            try {
+                number = std::stod(source.substr(i), &end);
+            } catch (const std::exception &) {
+                syntax_error("bad number", i);
+            }
+            tokens.push_back(
+                {Token::Kind::NUMBER, source.substr(i, end), number, i});
+            i += end;
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            auto start = i;
+            while (i < source.size() &&
+                   (std::isalnum(static_cast<unsigned char>(source[i])) ||
+                    source[i] == '_'))
+                ++i;
+            tokens.push_back({Token::Kind::NAME,
+                              source.substr(start, i - start), 0., start});
+        } else {
+            // two character symbols first
+            auto two = source.substr(i, 2);
+            if (two == "->" || two == "<=" || two == ">=" || two == "==" ||
+                two == "!=") {
+                tokens.push_back({Token::Kind::SYMBOL, two, 0., i});
+                i += 2;
+                continue;
+            }
+            if (string("+-*/<>(),").find(c) == string::npos)
+                syntax_error(string("unexpected '") + c + "'", i);
+            depth += c == '(' ? 1 : c == ')' ? -1 : 0;
+            tokens.push_back({Token::Kind::SYMBOL, string(1, c), 0., i++});
+        }
+    }
+    tokens.push_back({Token::Kind::END, "", 0., source.size()});
+    return tokens;
+}
+
+// recursive descent over the tokens, lowest precedence first
+class Parser {
+   public:
+    explicit Parser(const string &source) : tokens_(tokenize(source)) {}
+
+    vector<ExprRule> rules() {
+        vector<ExprRule> rules;
+        while (true) {
+            while (this->_peek().kind == Token::Kind::SEPARATOR) ++this->next_;
+            if (this->_peek().kind == Token::Kind::END) return rules;
+
+            ExprRule rule;
+            rule.condition = this->_or();
+            this->_expect("->");
+            auto &action = this->_next();
+            if (action.text != "buy" && action.text != "sell")
+                syntax_error("expected buy or sell", action.pos);
+            rule.buy = action.text == "buy";
+            rule.size = this->_or();
+            rules.push_back(rule);
+
+            auto kind = this->_peek().kind;
+            if (kind != Token::Kind::SEPARATOR && kind != Token::Kind::END)
+                syntax_error("expected the end of the rule",
+                             this->_peek().pos);
+        }
+    }
+
+   private:
+    using Node = shared_ptr<const ExprNode>;
+
+    const Token &_peek() const { return this->tokens_[this->next_]; }
+    const Token &_next() {
+        auto &token = this->tokens_[this->next_];
+        if (token.kind != Token::Kind::END) ++this->next_;
+        return token;
+    }
+    bool _accept(const string &text) {
+        auto &token = this->_peek();
+        if ((token.kind != Token::Kind::SYMBOL &&
+             token.kind != Token::Kind::NAME) ||
+            token.text != text)
+            return false;
+        ++this->next_;
+        return true;
+    }
+    void _expect(const string &text) {
+        if (!this->_accept(text))
+            syntax_error("expected '" + text + "'", this->_peek().pos);
+    }
+
+    Node _binary(const string &op, const Node &lhs, const Node &rhs,
+                 const size_t pos) {
+        return make_shared<const ExprNode>(
+            ExprNode{Kind::BINARY, 0., op, {lhs, rhs}, pos});
+    }
+
+    Node _or() {
+        auto lhs = this->_and();
+        while (true) {
+            auto pos = this->_peek().pos;
+            if (!this->_accept("or")) return lhs;
+            lhs = this->_binary("or", lhs, this->_and(), pos);
+        }
+    }
+
+    Node _and() {
+        auto lhs = this->_not();
+        while (true) {
+            auto pos = this->_peek().pos;
+            if (!this->_accept("and")) return lhs;
+            lhs = this->_binary("and", lhs, this->_not(), pos);
+        }
+    }
+
+    Node _not() {
+        auto pos = this->_peek().pos;
+        if (!this->_accept("not")) return this->_compare();
+        return make_shared<const ExprNode>(
+            ExprNode{Kind::UNARY, 0., "not", {this->_not()}, pos});
+    }
+
+    Node _compare() {
+        auto lhs = this->_sum();
+        auto &token = this->_peek();
+        for (auto op : {"<", "<=", ">", ">=", "==", "!="}) {
+            if (this->_accept(op))
+                return this->_binary(op, lhs, this->_sum(), token.pos);
+        }
+        return lhs;
+    }
+
+    Node _sum() {
+        auto lhs = this->_product();
+        while (true) {
+            auto &token = this->_peek();
+            if (this->_accept("+"))
+                lhs = this->_binary("+", lhs, this->_product(), token.pos);
+            else if (this->_accept("-"))
+                lhs = this->_binary("-", lhs, this->_product(), token.pos);
+            else
+                return lhs;
+        }
+    }
+
+    Node _product() {
+        auto lhs = this->_unary();
+        while (true) {
+            auto &token = this->_peek();
+            if (this->_accept("*"))
+                lhs = this->_binary("*", lhs, this->_unary(), token.pos);
+            else if (this->_accept("/"))
+                lhs = this->_binary("/", lhs, this->_unary(), token.pos);
+            else
+                return lhs;
+        }
+    }
+
+    Node _unary() {
+        auto pos = this->_peek().pos;
+        if (!this->_accept("-")) return this->_primary();
+        return make_shared<const ExprNode>(
+            ExprNode{Kind::UNARY, 0., "-", {this->_unary()}, pos});
+    }
+
+    Node _primary() {
+        auto &token = this->_next();
+        if (token.kind == Token::Kind::NUMBER) {
+            return make_shared<const ExprNode>(
+                ExprNode{Kind::NUMBER, token.number, "", {}, token.pos});
+        }
+        if (token.kind == Token::Kind::SYMBOL && token.text == "(") {
+            auto node = this->_or();
+            this->_expect(")");
+            return node;
+        }
+        if (token.kind != Token::Kind::NAME)
+            syntax_error("expected an expression", token.pos);
+
+        if (!this->_accept("(")) {
+            return make_shared<const ExprNode>(
+                ExprNode{Kind::NAME, 0., token.text, {}, token.pos});
+        }
+        ExprNode call{Kind::CALL, 0., token.text, {}, token.pos};
+        if (!this->_accept(")")) {
+            do {
+                call.args.push_back(this->_or());
+            } while (this->_accept(","));
+            this->_expect(")");
+        }
+        return make_shared<const ExprNode>(std::move(call));
+    }
+
+    vector<Token> tokens_;
+    size_t next_ = 0;
+};
+
+string column_name(const string &label, const string &field) {
+    return "('" + label + "', '" + field + "')";
+}
+
+[[noreturn]] void eval_error(const ExprNode &node, const string &what) {
+    throw std::invalid_argument("Rule error at " + std::to_string(node.pos) +
+                                ": " + what);
+}
+
+void check_args(const ExprNode &node, const size_t n) {
+    if (node.args.size() != n)
+        eval_error(node, node.name + " takes " + std::to_string(n) +
+                             " arguments");
+}
+
+// value of a window, span or lag argument: a number or numeric parameter,
+// possibly negated
+double constant(const ExprNode &node, const ParamMap &params) {
+    if (node.kind == Kind::NUMBER) return node.number;
+    if (node.kind == Kind::UNARY && node.name == "-")
+        return -constant(*node.args[0], params);
+    if (node.kind == Kind::NAME) {
+        if (auto it = params.find(node.name); it != params.end()) {
+            if (auto v = std::get_if<int>(&it->second)) return *v;
+            if (auto v = std::get_if<double>(&it->second)) return *v;
+        }
+    }
+    eval_error(node, "expected a number or numeric parameter");
+}
+
+int64_t integer(const ExprNode &node, const ParamMap &params,
+                const int64_t min) {
+    auto value = constant(node, params);
+    if (value != std::floor(value) || value < min)
+        eval_error(node, "expected an integer of at least " +
+                             std::to_string(min));
+    return static_cast<int64_t>(value);
+}
+
+int64_t node_lookback(const ExprNode &node, const ParamMap &params) {
+    int64_t lookback = 0;
+    for (auto &arg : node.args)
+        lookback = std::max(lookback, node_lookback(*arg, params));
+    if (node.kind != Kind::CALL) return lookback;
+
+    if (kWindowFunctions.contains(node.name)) {
+        check_args(node, 2);
+        auto children = node_lookback(*node.args[0], params);
+        return std::max(lookback,
+                        children + integer(*node.args[1], params, 1) - 1);
+    }
+    if (node.name == "ema") {
+        check_args(node, 2);
+        auto span = constant(*node.args[1], params);
+        auto children = node_lookback(*node.args[0], params);
+        return std::max(lookback,
+                        children + static_cast<int64_t>(std::ceil(4 * span)));
+    }
+    if (node.name == "lag") {
+        check_args(node, 2);
+        return node_lookback(*node.args[0], params) +
+               integer(*node.args[1], params, 0);
+    }
+    if (node.name == "cross") return lookback + 1;
+    return lookback;
+}
+
+Datum check(const arrow::Result<Datum> &result, const ExprNode &node) {
+    if (!result.ok()) eval_error(node, result.status().ToString());
+    return result.ValueOrDie();
+}
+
+shared_ptr<ChunkedArray> to_chunked(const Datum &value) {
+    if (value.is_chunked_array()) return value.chunked_array();
+    return make_shared<ChunkedArray>(value.make_array());
+}
+
+// evaluates rule expressions over a table. every distinct subexpression
+// (after substituting params) is computed once, so shared averages and
+// the like form a DAG rather than a tree.
+class Evaluator {
+   public:
+    Evaluator(const shared_ptr<const Table> &data, const string &data_label,
+              const ParamMap &params,
+              const shared_ptr<IndicatorCache> &indicators)
+        : data_(data),
+          data_label_(data_label),
+          params_(params),
+          indicators_(indicators) {
+        static const auto registered = RegisterComputeFunctions();
+        CHECK(registered.ok()) << "Error: " << registered;
+    }
+
+    // a column of length num_rows() or a scalar
+    const Datum &evaluate(const ExprNode &node) {
+        return this->_entry(node).value;
+    }
+
+    // value as a column, scalars repeated over every row
+    shared_ptr<ChunkedArray> column(const ExprNode &node,
+                                    const shared_ptr<arrow::DataType> &type) {
+        auto value = this->evaluate(node);
+        if (value.is_scalar()) {
+            auto st_ma = arrow::MakeArrayFromScalar(*value.scalar(),
+                                                    this->data_->num_rows());
+            if (!st_ma.ok()) eval_error(node, st_ma.status().ToString());
+            value = st_ma.ValueOrDie();
+        }
+        return to_chunked(check(arrow::compute::Cast(value, type), node));
+    }
+
+   private:
+    struct Entry {
+        string key;
+        Datum value;
+        // a column of the data, which the indicator cache can key on
+        bool is_column = false;
+    };
+
+    const Entry &_entry(const ExprNode &node) {
+        vector<const Entry *> args;
+        auto key = node.name + "(";
+        if (node.kind == Kind::NUMBER) {
+            key = std::format("{}", node.number);
+        } else if (node.kind == Kind::NAME) {
+            key = "$" + node.name;
+        } else {
+            for (auto &arg : node.args) {
+                args.push_back(&this->_entry(*arg));
+                key += args.back()->key + ",";
+            }
+            key += ")";
+        }
+        if (auto it = this->memo_.find(key); it != this->memo_.end())
+            return it->second;
+
+        Entry entry{key, {}, false};
+        switch (node.kind) {
+            case Kind::NUMBER:
+                entry.value = Datum(node.number);
+                break;
+            case Kind::NAME:
+                entry = this->_name(node, key);
+                break;
+            case Kind::UNARY:
+                entry.value = check(
+                    arrow::compute::CallFunction(
+                        node.name == "-" ? "negate" : "invert",
+                        {args[0]->value}),
+                    node);
+                break;
+            case Kind::BINARY:
+                entry.value = check(
+                    arrow::compute::CallFunction(kOperators.at(node.name),
+                                                 {args[0]->value,
+                                                  args[1]->value}),
+                    node);
+                break;
+            case Kind::CALL:
+                entry.value = this->_call(node, args);
+                break;
+        }
+        return this->memo_.emplace(key, std::move(entry)).first->second;
+    }
+
+    // a parameter, or the asset's field, or a column of that name
+    Entry _name(const ExprNode &node, const string &key) {
+        if (auto it = this->params_.find(node.name);
+            it != this->params_.end()) {
+            auto &value = it->second;
+            if (auto v = std::get_if<int>(&value))
+                return {key, Datum(static_cast<double>(*v))};
+            if (auto v = std::get_if<double>(&value)) return {key, Datum(*v)};
+            if (auto v = std::get_if<bool>(&value)) return {key, Datum(*v)};
+            eval_error(node, "parameter " + node.name + " is not a number");
+        }
+        for (auto &name :
+             {column_name(this->data_label_, node.name), node.name}) {
+            if (auto column = this->data_->GetColumnByName(name))
+                return {key, Datum(column), true};
+        }
+        eval_error(node, "unknown name " + node.name);
+    }
+
+    Datum _call(const ExprNode &node, const vector<const Entry *> &args) {
+        auto &name = node.name;
+        auto source = [&]() {
+            if (args[0]->value.is_scalar())
+                eval_error(node, name + " needs a column");
+            return to_chunked(args[0]->value);
+        };
+
+        if (auto it = kWindowFunctions.find(name);
+            it != kWindowFunctions.end() || name == "ema") {
+            check_args(node, 2);
+            auto function = name == "ema" ? string("yabte_ema") : it->second;
+            vector<ParamValue> params;
+            if (name == "ema")
+                params.push_back(constant(*node.args[1], this->params_));
+            else
+                params.push_back(static_cast<int>(
+                    integer(*node.args[1], this->params_, 1)));
+
+            // data columns are shared by the runs of a batch
+            if (args[0]->is_column && this->indicators_) {
+                auto st_c = this->indicators_->compute(source(), function,
+                                                       params);
+                if (!st_c.ok()) eval_error(node, st_c.status().ToString());
+                return st_c.ValueOrDie();
+            }
+            auto window =
+                name == "ema"
+                    ? Datum(std::get<double>(params[0]))
+                    : Datum(static_cast<int64_t>(std::get<int>(params[0])));
+            return check(arrow::compute::CallFunction(function,
+                                                      {source(), window}),
+                         node);
+        }
+
+        if (name == "cross") {
+            check_args(node, 2);
+            return check(arrow::compute::CallFunction(
+                             "yabte_crossover",
+                             {this->column(*node.args[0], arrow::float64()),
+                              this->column(*node.args[1], arrow::float64())}),
+                         node);
+        }
+
+        if (name == "lag") {
+            check_args(node, 2);
+            auto values = this->column(*node.args[0], arrow::float64());
+            auto k = std::min(integer(*node.args[1], this->params_, 0),
+                              values->length());
+            auto st_mn = arrow::MakeArrayOfNull(arrow::float64(), k);
+            if (!st_mn.ok()) eval_error(node, st_mn.status().ToString());
+            arrow::ArrayVector chunks{st_mn.ValueOrDie()};
+            auto kept = values->Slice(0, values->length() - k);
+            chunks.insert(chunks.end(), kept->chunks().begin(),
+                          kept->chunks().end());
+            return make_shared<ChunkedArray>(chunks, arrow::float64());
+        }
+
+        if (name == "abs") {
+            check_args(node, 1);
+            return check(arrow::compute::CallFunction("abs", {args[0]->value}),
+                         node);
+        }
+
+        eval_error(node, "unknown function " + name);
+    }
+
+    shared_ptr<const Table> data_;
+    string data_label_;
+    const ParamMap &params_;
+    shared_ptr<IndicatorCache> indicators_;
+    map<string, Entry> memo_;
+};
+
+}  // namespace
+
+vector<ExprRule> ParseExprRules(const string &source) {
+    return Parser(source).rules();
+}
+
+ExprStrategy::ExprStrategy(const string &source, const string &asset_name)
+    : source_(source),
+      asset_name_(asset_name),
+      rules_(ParseExprRules(source)) {}
+
+shared_ptr<Strategy> ExprStrategy::clone() const {
+    return make_shared<ExprStrategy>(*this);
+}
+
+string ExprStrategy::_data_label() const {
+    if (this->asset_map_) {
+        if (auto it = this->asset_map_->find(this->asset_name_);
+            it != this->asset_map_->end())
+            return it->second->data_label_;
+    }
+    return this->asset_name_;
+}
+
+shared_ptr<const Table> ExprStrategy::extend_data(
+    const shared_ptr<const Table> &data) {
+    auto label = this->_data_label();
+    Evaluator evaluator(data, label, this->params_, this->indicators_);
+
+    arrow::FieldVector fields;
+    vector<shared_ptr<ChunkedArray>> columns;
+    for (size_t i = 0; i < this->rules_.size(); ++i) {
+        auto &rule = this->rules_[i];
+        auto n = std::to_string(i);
+        fields.push_back(
+            arrow::field(column_name(label, "rule_" + n), arrow::boolean()));
+        columns.push_back(evaluator.column(*rule.condition, arrow::boolean()));
+        fields.push_back(
+            arrow::field(column_name(label, "size_" + n), arrow::float64()));
+        columns.push_back(evaluator.column(*rule.size, arrow::float64()));
+    }
+    return Table::Make(arrow::schema(fields), columns, data->num_rows());
+}
+
+void ExprStrategy::on_close() {
+    if (this->condition_columns_.empty() && !this->rules_.empty()) {
+        auto label = this->_data_label();
+        for (size_t i = 0; i < this->rules_.size(); ++i) {
+            auto n = std::to_string(i);
+            auto condition =
+                this->data_->column_index(column_name(label, "rule_" + n));
+            auto size =
+                this->data_->column_index(column_name(label, "size_" + n));
+            CHECK(condition >= 0 && size >= 0)
+                << "Error: rule columns not found";
+            this->condition_columns_.push_back(condition);
+            this->size_columns_.push_back(size);
+        }
+    }
+
+    for (size_t i = 0; i < this->rules_.size(); ++i) {
+        auto condition = this->data_->column(this->condition_columns_[i]);
+        if (!condition.is_valid(-1) || condition.last() == 0.) continue;
+        auto size = this->data_->column(this->size_columns_[i]).last();
+        if (std::isnan(size) || size == 0.) continue;
+        this->orders_->push_back(make_run_shared<SimpleOrder>(
+            this->asset_name_, this->rules_[i].buy ? size : -size));
+    }
+}
+
+int64_t ExprStrategy::lookback() const {
+    int64_t lookback = 0;
+    for (auto &rule : this->rules_) {
+        lookback = std::max({lookback,
+                             node_lookback(*rule.condition, this->params_),
+                             node_lookback(*rule.size, this->params_)});
+    }
+    return lookback;
+}
+
+}  // namespace YABTE::BackTest
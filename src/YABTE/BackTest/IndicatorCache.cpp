@@ -0,0 +1,128 @@
+#include "YABTE/BackTest/IndicatorCache.hpp"
+
+#include <arrow/compute/api.h>
+
+#include <type_traits>
+
+#include "YABTE/Utilities/Arrow/ComputeFunctions.hpp"
+
+using arrow::Datum, arrow::Status;
+
+using YABTE::Utilities::Arrow::RegisterComputeFunctions;
+
+namespace YABTE::BackTest {
+
+IndicatorCache::Key IndicatorCache::_key(
+    const shared_ptr<ChunkedArray> &source, const string &kernel,
+    const vector<ParamValue> &params) {
+    SourceId id;
+    for (auto const &chunk : source->chunks()) {
+        auto &data = chunk->data();
+        auto address = [&](const size_t i) -> uintptr_t {
+            auto buffer =
+                data->buffers.size() > i ? data->buffers[i].get() : nullptr;
+            return buffer ? reinterpret_cast<uintptr_t>(buffer->data()) : 0;
+        };
+        // the validity bitmap too, the same values with other nulls are
+        // another source
+        id.emplace_back(address(1), address(0), data->offset, data->length);
+    }
+    return {std::move(id), source->type()->id(), kernel, params};
+}
+
+Result<shared_ptr<ChunkedArray>> IndicatorCache::get_or_compute(
+    const shared_ptr<ChunkedArray> &source, const string &kernel,
+    const vector<ParamValue> &params, const Compute &compute) {
+    auto key = _key(source, kernel, params);
+
+    std::promise<Result<shared_ptr<ChunkedArray>>> promise;
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    if (auto it = this->entries_.find(key); it != this->entries_.end()) {
+        ++this->hits_;
+        auto value = it->second.value;
+        // wait outside the lock, the entry may still be computing
+        lock.unlock();
+        return value.get();
+    }
+    ++this->misses_;
+    this->entries_.emplace(key, Entry{source, promise.get_future().share()});
+    lock.unlock();
+
+    // failures aren't cached, waiters get the failure and the next lookup
+    // computes again
+    auto forget = [&]() {
+        lock.lock();
+        this->entries_.erase(key);
+        lock.unlock();
+    };
+    Result<shared_ptr<ChunkedArray>> result;
+    try {
+        result = compute();
+    } catch (...) {
+        forget();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    if (!result.ok()) forget();
+    promise.set_value(result);
+    return result;
+}
+
+Result<shared_ptr<ChunkedArray>> IndicatorCache::compute(
+    const shared_ptr<ChunkedArray> &source, const string &function,
+    const vector<ParamValue> &params) {
+    // make sure the yabte_* functions are available
+    static const auto registered = RegisterComputeFunctions();
+    ARROW_RETURN_NOT_OK(registered);
+
+    return this->get_or_compute(
+        source, function, params,
+        [&]() -> Result<shared_ptr<ChunkedArray>> {
+            vector<Datum> args{source};
+            for (auto const &p : params) {
+                std::visit(
+                    [&](auto &&v) {
+                        using T = std::decay_t<decltype(v)>;
+                        if constexpr (std::is_same_v<T, int>)
+                            args.emplace_back(static_cast<int64_t>(v));
+                        else
+                            args.emplace_back(v);
+                    },
+                    p);
+            }
+            ARROW_ASSIGN_OR_RAISE(auto out,
+                                  arrow::compute::CallFunction(function, args));
+            if (out.is_array())
+                return std::make_shared<ChunkedArray>(out.make_array());
+            if (out.is_chunked_array()) return out.chunked_array();
+            return Status::Invalid("Function ", function,
+                                   " did not return an array");
+        });
+}
+
+Status IndicatorCache::precompute(const vector<Request> &requests,
+                                  Executor &executor) {
+    vector<Status> statuses(requests.size());
+    executor.parallel_for(0, requests.size(), [&](int64_t i) {
+        auto &request = requests[i];
+        statuses[i] =
+            this->compute(request.source, request.function, request.params)
+                .status();
+    });
+    for (auto &status : statuses) ARROW_RETURN_NOT_OK(status);
+    return Status::OK();
+}
+
+IndicatorCache::Stats IndicatorCache::stats() const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    return {this->hits_, this->misses_, this->entries_.size()};
+}
+
+void IndicatorCache::clear() {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->entries_.clear();
+    this->hits_ = 0;
+    this->misses_ = 0;
+}
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,35 @@
+#include "YABTE/BackTest/LaneStrategy.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace YABTE::BackTest {
+
+LaneOrders::LaneOrders(const vector<string> &asset_names,
+                       const size_t num_lanes)
+    : asset_names_(asset_names), num_lanes_(num_lanes) {
+    std::sort(this->asset_names_.begin(), this->asset_names_.end());
+}
+
+void LaneOrders::push(const size_t lane, const string &asset_name,
+                      const double size, const OrderSizeType size_type,
+                      const optional<string> &book_name,
+                      const optional<string> &label) {
+    if (lane >= this->num_lanes_) {
+        throw std::out_of_range("Lane out of range");
+    }
+    auto it = std::lower_bound(this->asset_names_.begin(),
+                               this->asset_names_.end(), asset_name);
+    if (it == this->asset_names_.end() || *it != asset_name) {
+        throw std::out_of_range("Asset not found: " + asset_name);
+    }
+    this->orders_.push_back(
+        {lane, static_cast<size_t>(it - this->asset_names_.begin()), size,
+         size_type, book_name, label});
+}
+
+void LaneStrategy::init_lanes() {}
+void LaneStrategy::on_open_lanes(LaneOrders &orders) {}
+void LaneStrategy::on_close_lanes(LaneOrders &orders) {}
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,247 @@
+#include "YABTE/BackTest/Ledger.hpp"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/util/bit_util.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using std::make_shared;
+
+namespace YABTE::BackTest {
+
+namespace {
+
+shared_ptr<arrow::Buffer> allocate(const int64_t size) {
+    auto st_ab = arrow::AllocateBuffer(size);
+    CHECK(st_ab.ok()) << "Error: " << st_ab.status();
+    return shared_ptr<arrow::Buffer>(std::move(st_ab).ValueOrDie());
+}
+
+template <typename T>
+T *mutable_values(const shared_ptr<arrow::Buffer> &buffer) {
+    return reinterpret_cast<T *>(buffer->mutable_data());
+}
+
+// rows of a chunk column, the buffers are shared not copied
+shared_ptr<arrow::Array> chunk_array(
+    const shared_ptr<arrow::DataType> &type, const int64_t length,
+    const shared_ptr<arrow::Buffer> &values,
+    const shared_ptr<arrow::Buffer> &validity = nullptr) {
+    auto data = arrow::ArrayData::Make(
+        type, length, {validity, values},
+        validity ? arrow::kUnknownNullCount : 0);
+    return arrow::MakeArray(data);
+}
+
+shared_ptr<arrow::Array> string_array(const vector<string> &values) {
+    arrow::StringBuilder builder;
+    CHECK(builder.AppendValues(values).ok());
+    return builder.Finish().ValueOrDie();
+}
+
+}  // namespace
+
+Ledger::Ledger(const Ledger &other)
+    : chunks_(other.chunks_),
+      size_(other.size_),
+      num_trades_(other.num_trades_),
+      labels_(other.labels_),
+      label_ids_(other.label_ids_) {
+    if (this->size_ % kChunkRows != 0) {
+        auto &last = this->chunks_.back();
+        last = copy_chunk(last, last.capacity);
+    }
+}
+
+Ledger &Ledger::operator=(const Ledger &other) {
+    if (this != &other) *this = Ledger(other);
+    return *this;
+}
+
+Ledger::Chunk Ledger::make_chunk(const int64_t capacity) {
+    auto bitmap = arrow::bit_util::BytesForBits(capacity);
+    return {allocate(capacity * sizeof(int64_t)),
+            allocate(capacity * sizeof(int8_t)),
+            allocate(capacity * sizeof(int32_t)),
+            allocate(bitmap),
+            allocate(capacity * sizeof(double)),
+            allocate(capacity * sizeof(double)),
+            allocate(capacity * sizeof(double)),
+            allocate(capacity * sizeof(int32_t)),
+            allocate(bitmap),
+            capacity};
+}
+
+Ledger::Chunk Ledger::copy_chunk(const Chunk &chunk, const int64_t capacity) {
+    auto copy = make_chunk(capacity);
+    for (auto column : {&Chunk::ts, &Chunk::kind, &Chunk::asset,
+                        &Chunk::asset_valid, &Chunk::quantity, &Chunk::price,
+                        &Chunk::total, &Chunk::label, &Chunk::label_valid}) {
+        std::memcpy((copy.*column)->mutable_data(), (chunk.*column)->data(),
+                    (chunk.*column)->size());
+    }
+    return copy;
+}
+
+int32_t Ledger::intern_label(const string &label) {
+    auto [it, inserted] = this->label_ids_.emplace(
+        label, static_cast<int32_t>(this->labels_.size()));
+    if (inserted) this->labels_.push_back(label);
+    return it->second;
+}
+
+void Ledger::append(const Timestamp &ts, const TransactionKind kind,
+                    const AssetId asset_id, const double quantity,
+                    const double price, const double total,
+                    const optional<string> &label) {
+    auto i = this->size_ % kChunkRows;
+    if (i == 0) {
+        this->chunks_.push_back(
+            make_chunk(this->chunks_.empty() ? kFirstChunkRows : kChunkRows));
+    } else if (i == this->chunks_.back().capacity) {
+        auto &last = this->chunks_.back();
+        last = copy_chunk(last, std::min(2 * i, kChunkRows));
+    }
+    auto &chunk = this->chunks_.back();
+
+    auto label_id = label ? this->intern_label(*label) : -1;
+    mutable_values<int64_t>(chunk.ts)[i] =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            ts.time_since_epoch())
+            .count();
+    mutable_values<int8_t>(chunk.kind)[i] = static_cast<int8_t>(kind);
+    mutable_values<int32_t>(chunk.asset)[i] = asset_id;
+    arrow::bit_util::SetBitTo(chunk.asset_valid->mutable_data(), i,
+                              asset_id != NO_ASSET_ID);
+    mutable_values<double>(chunk.quantity)[i] = quantity;
+    mutable_values<double>(chunk.price)[i] = price;
+    mutable_values<double>(chunk.total)[i] = total;
+    mutable_values<int32_t>(chunk.label)[i] = label_id;
+    arrow::bit_util::SetBitTo(chunk.label_valid->mutable_data(), i,
+                              label_id >= 0);
+
+    ++this->size_;
+    if (kind == TransactionKind::TRADE) ++this->num_trades_;
+}
+
+void Ledger::append_trade(const Timestamp &ts, const AssetId asset_id,
+                          const double quantity, const double price,
+                          const optional<string> &label) {
+    this->append(ts, TransactionKind::TRADE, asset_id, quantity, price,
+                 -quantity * price, label);
+}
+
+void Ledger::append_cash(const Timestamp &ts, const double total,
+                         const string &desc) {
+    this->append(ts, TransactionKind::CASH, NO_ASSET_ID, 0., 0., total, desc);
+}
+
+Timestamp Ledger::ts(const int64_t row) const {
+    return timestamp_from_ns(this->value<int64_t>(&Chunk::ts, row));
+}
+
+TransactionKind Ledger::kind(const int64_t row) const {
+    return static_cast<TransactionKind>(
+        this->value<int8_t>(&Chunk::kind, row));
+}
+
+AssetId Ledger::asset_id(const int64_t row) const {
+    return this->value<int32_t>(&Chunk::asset, row);
+}
+
+double Ledger::quantity(const int64_t row) const {
+    return this->value<double>(&Chunk::quantity, row);
+}
+
+double Ledger::price(const int64_t row) const {
+    return this->value<double>(&Chunk::price, row);
+}
+
+double Ledger::total(const int64_t row) const {
+    return this->value<double>(&Chunk::total, row);
+}
+
+optional<string> Ledger::label(const int64_t row) const {
+    auto label_id = this->value<int32_t>(&Chunk::label, row);
+    if (label_id < 0) return std::nullopt;
+    return this->labels_[label_id];
+}
+
+shared_ptr<Transaction> Ledger::transaction(const int64_t row,
+                                            const SymbolTable &symbols) const {
+    if (this->kind(row) == TransactionKind::CASH) {
+        return make_shared<CashTransaction>(this->ts(row), this->total(row),
+                                            this->label(row).value_or(""));
+    }
+    auto trade = make_shared<Trade>(this->ts(row), this->quantity(row),
+                                    this->price(row),
+                                    symbols.name(this->asset_id(row)),
+                                    this->label(row));
+    trade->total_ = this->total(row);
+    trade->asset_id_ = this->asset_id(row);
+    return trade;
+}
+
+TransactionVector Ledger::transactions(const SymbolTable &symbols) const {
+    TransactionVector transactions;
+    transactions.reserve(this->size_);
+    for (int64_t row = 0; row < this->size_; ++row)
+        transactions.push_back(this->transaction(row, symbols));
+    return transactions;
+}
+
+shared_ptr<arrow::Table> Ledger::to_table(const SymbolTable &symbols) const {
+    auto kind_type = arrow::dictionary(arrow::int8(), arrow::utf8());
+    auto id_type = arrow::dictionary(arrow::int32(), arrow::utf8());
+    auto kinds = string_array({"cash", "trade"});
+    auto assets = string_array(symbols.names_);
+    auto labels = string_array(this->labels_);
+
+    vector<arrow::ArrayVector> columns(7);
+    for (size_t c = 0; c < this->chunks_.size(); ++c) {
+        auto &chunk = this->chunks_[c];
+        auto n = std::min<int64_t>(kChunkRows, this->size_ - c * kChunkRows);
+        auto doubles = [&](auto &values) {
+            return chunk_array(arrow::float64(), n, values);
+        };
+
+        columns[0].push_back(chunk_array(
+            arrow::timestamp(arrow::TimeUnit::NANO), n, chunk.ts));
+        columns[1].push_back(make_shared<arrow::DictionaryArray>(
+            kind_type, chunk_array(arrow::int8(), n, chunk.kind), kinds));
+        columns[2].push_back(make_shared<arrow::DictionaryArray>(
+            id_type,
+            chunk_array(arrow::int32(), n, chunk.asset, chunk.asset_valid),
+            assets));
+        columns[3].push_back(doubles(chunk.quantity));
+        columns[4].push_back(doubles(chunk.price));
+        columns[5].push_back(doubles(chunk.total));
+        columns[6].push_back(make_shared<arrow::DictionaryArray>(
+            id_type,
+            chunk_array(arrow::int32(), n, chunk.label, chunk.label_valid),
+            labels));
+    }
+
+    arrow::FieldVector fields{
+        arrow::field("ts", arrow::timestamp(arrow::TimeUnit::NANO)),
+        arrow::field("kind", kind_type),
+        arrow::field("asset", id_type),
+        arrow::field("quantity", arrow::float64()),
+        arrow::field("price", arrow::float64()),
+        arrow::field("total", arrow::float64()),
+        arrow::field("label", id_type)};
+
+    arrow::ChunkedArrayVector chunked;
+    for (size_t c = 0; c < fields.size(); ++c) {
+        chunked.push_back(
+            arrow::ChunkedArray::Make(columns[c], fields[c]->type())
+                .ValueOrDie());
+    }
+    return arrow::Table::Make(arrow::schema(fields), chunked, this->size_);
+}
+
+}  // namespace YABTE::BackTest
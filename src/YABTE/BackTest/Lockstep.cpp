@@ -0,0 +1,332 @@
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "YABTE/BackTest/LaneStrategy.hpp"
+#include "YABTE/BackTest/StrategyRunner.hpp"
+
+using std::make_shared, std::dynamic_pointer_cast;
+
+namespace YABTE::BackTest {
+
+namespace {
+
+constexpr size_t kInterest = std::numeric_limits<size_t>::max();
+
+// a booked trade, or an interest payment when order is kInterest
+struct LaneTransaction {
+    Timestamp ts;
+    size_t order;  // index into LaneState::processed of the lane
+    double quantity;
+    double price;
+    double total;
+};
+
+// book state of every lane in structure of arrays form, values for the
+// lanes of a book (and asset) are contiguous so end of day tasks are tight
+// loops across lanes
+struct LaneState {
+    LaneState(const BookVector &books, const vector<string> &asset_names,
+              const size_t num_lanes)
+        : num_books(books.size()),
+          num_assets(asset_names.size()),
+          num_lanes(num_lanes),
+          cash(num_books * num_lanes),
+          positions(num_books * num_assets * num_lanes, 0.),
+          held(num_books * num_assets * num_lanes, 0),
+          transactions(num_books * num_lanes),
+          processed(num_lanes) {
+        for (size_t b = 0; b < num_books; ++b) {
+            std::fill_n(this->cash.begin() + this->slot(b, 0), num_lanes,
+                        books[b]->cash_);
+            // books may start with positions
+            for (auto const &[an, q] : books[b]->positions()) {
+                auto it = std::lower_bound(asset_names.begin(),
+                                           asset_names.end(), an);
+                if (it == asset_names.end() || *it != an) {
+                    throw std::out_of_range("Asset not found: " + an);
+                }
+                auto p = this->position(b, it - asset_names.begin(), 0);
+                std::fill_n(this->positions.begin() + p, num_lanes, q);
+                std::fill_n(this->held.begin() + p, num_lanes, 1);
+            }
+        }
+    }
+
+    size_t slot(const size_t book, const size_t lane) const {
+        return book * this->num_lanes + lane;
+    }
+    size_t position(const size_t book, const size_t asset,
+                    const size_t lane) const {
+        return (book * this->num_assets + asset) * this->num_lanes + lane;
+    }
+
+    size_t num_books, num_assets, num_lanes;
+    vector<double> cash;       // [book][lane]
+    vector<double> positions;  // [book][asset][lane]
+    vector<uint8_t> held;      // as positions, set once the lane holds it
+    vector<vector<LaneTransaction>> transactions;  // [book][lane]
+    vector<vector<tuple<LaneOrder, size_t>>> processed;  // [lane]
+    vector<Timestamp> days;
+    vector<double> history_cash, history_mtm;  // [day][book][lane]
+};
+
+// same as SimpleOrder::apply followed by Book::add_transactions
+void process_order(LaneState &state, const LaneOrder &order,
+                   const size_t book, const Asset &asset, const Timestamp &ts,
+                   const DayView &day_data) {
+    auto trade_price = asset.intraday_traded_price(day_data, order.size);
+    auto s = state.slot(book, order.lane);
+
+    double trade_quantity;
+    if (order.size_type == OrderSizeType::QUANTITY)
+        trade_quantity = asset.round_quantity(order.size);
+    else if (order.size_type == OrderSizeType::NOTIONAL)
+        trade_quantity = asset.round_quantity(order.size / trade_price);
+    else if (order.size_type == OrderSizeType::BOOK_PERCENT)
+        trade_quantity = asset.round_quantity(state.cash[s] * order.size /
+                                              100 / trade_price);
+    else
+        throw std::runtime_error("Unsupported size type");
+
+    auto total = -trade_quantity * trade_price;
+    auto p = state.position(book, order.asset, order.lane);
+    state.positions[p] += trade_quantity;
+    state.held[p] = 1;
+    state.cash[s] += total;
+
+    auto &processed = state.processed[order.lane];
+    processed.emplace_back(order, book);
+    state.transactions[s].push_back(
+        {ts, processed.size() - 1, trade_quantity, trade_price, total});
+}
+
+// same as Book::eod_tasks for every lane of a book
+void eod_tasks(LaneState &state, const size_t b, const Book &book,
+               const AssetVector &assets, const Timestamp &ts,
+               const DayView &day_data) {
+    auto L = state.num_lanes;
+    auto cash = state.cash.data() + state.slot(b, 0);
+
+    if (book.rate_ != 0) {
+        auto growth = std::exp(book.rate_) - 1;
+        for (size_t l = 0; l < L; ++l) {
+            auto interest =
+                round_n_digits(cash[l] * growth, book.interest_round_dp_);
+            if (interest != 0) {
+                cash[l] += interest;
+                state.transactions[state.slot(b, l)].push_back(
+                    {ts, kInterest, 0., 0., interest});
+            }
+        }
+    }
+
+    // assets are in name order, as a book's positions map is
+    vector<double> mtm(L, 0.);
+    for (size_t a = 0; a < state.num_assets; ++a) {
+        auto p = state.position(b, a, 0);
+        auto held = state.held.data() + p;
+        if (std::none_of(held, held + L, [](auto h) { return h != 0; }))
+            continue;
+
+        auto price = assets[a]->end_of_day_price(day_data);
+        auto q = state.positions.data() + p;
+        for (size_t l = 0; l < L; ++l) {
+            if (held[l]) mtm[l] += price * q[l];
+        }
+    }
+
+    state.history_cash.insert(state.history_cash.end(), cash, cash + L);
+    state.history_mtm.insert(state.history_mtm.end(), mtm.begin(), mtm.end());
+}
+
+}  // namespace
+
+vector<StrategyRunnerResult> StrategyRunner::run_lockstep(
+    const vector<ParamMap> &params_vector) {
+    DLOG(INFO) << "Running strategy runner in lockstep";
+    auto L = params_vector.size();
+    if (L == 0) return {};
+
+    vector<shared_ptr<LaneStrategy>> strategies;
+    for (auto &s : this->strategies_) {
+        auto ls = dynamic_pointer_cast<LaneStrategy>(s->clone());
+        if (!ls) {
+            throw std::runtime_error("Lockstep runs need lane strategies");
+        }
+        strategies.push_back(ls);
+    }
+
+    // assets in name order, read only during the run so shared by lanes
+    ColumnPlan plan(this->data_->schema());
+    AssetVector assets;
+    for (auto &a : this->assets_) {
+        assets.push_back(a->clone());
+        assets.back()->columns_ = assets.back()->_resolve_columns(plan);
+    }
+    std::sort(assets.begin(), assets.end(),
+              [](auto &a, auto &b) { return a->name_ < b->name_; });
+
+    vector<string> asset_names;
+    auto symbols = make_shared<SymbolTable>(this->_asset_names());
+    auto asset_map = make_shared<AssetMap>(symbols);
+    for (auto &a : assets) {
+        asset_names.push_back(a->name_);
+        asset_map->add(a);
+    }
+
+    map<string, size_t> book_index;
+    for (size_t b = 0; b < this->books_.size(); ++b)
+        book_index.emplace(this->books_[b]->name_, b);
+
+    LaneState state(this->books_, asset_names, L);
+    LaneOrders orders(asset_names, L);
+
+    auto day_view = this->_day_table();
+    auto &day_table = *day_view;
+    auto date_index = day_table.column_index("Date");
+    CHECK(date_index >= 0) << "Error: Date column not found";
+    auto &calendar = day_table.column(date_index);
+
+    auto indicators = this->indicator_cache_ ? this->indicator_cache_
+                                             : make_shared<IndicatorCache>();
+
+    // init
+    for (auto &strategy : strategies) {
+        strategy->asset_map_ = asset_map;
+        strategy->lane_params_ = params_vector;
+        strategy->indicators_ = indicators;
+        strategy->data_ = make_shared<DataWindow>(this->data_);
+        strategy->init_lanes();
+    }
+
+    // run event loop
+    for (int64_t i = 0; i < day_table.num_rows(); ++i) {
+        if (!calendar.is_valid(i)) continue;
+
+        auto ts_chrono =
+            timestamp_from_ns(calendar.value<arrow::TimestampType::c_type>(i));
+        DayView day_data(day_table, i);
+
+        // open
+        for (auto &strategy : strategies) {
+            strategy->data_->advance_to(i + 1);
+            strategy->on_open_lanes(orders);
+        }
+
+        // process orders, lanes are independent so placement order is
+        // each lane's queue order
+        for (auto &order : orders.orders_) {
+            auto book = order.book_name.has_value()
+                            ? book_index.at(order.book_name.value())
+                            : 0;
+            process_order(state, order, book, *assets[order.asset],
+                          ts_chrono, day_data);
+        }
+        orders.orders_.clear();
+
+        // close
+        for (auto &strategy : strategies) {
+            strategy->on_close_lanes(orders);
+        }
+
+        // run book end-of-day tasks
+        state.days.push_back(ts_chrono);
+        for (size_t b = 0; b < state.num_books; ++b) {
+            eod_tasks(state, b, *this->books_[b], assets, ts_chrono,
+                      day_data);
+        }
+    }
+
+    // materialize a result per lane
+    vector<StrategyRunnerResult> results(L);
+    for (size_t l = 0; l < L; ++l) {
+        auto &result = results[l];
+        result.arena_ = make_shared<RunArena>();
+        ArenaScope arena_scope(result.arena_);
+
+        for (auto &a : this->assets_) {
+            result.assets_.push_back(a->clone());
+            result.assets_.back()->columns_ =
+                asset_map->at(a->name_)->columns_;
+        }
+        auto lane_asset_map = make_shared<AssetMap>(symbols);
+        for (auto &a : result.assets_) lane_asset_map->add(a);
+
+        auto lane_book_map = make_shared<BookMap>();
+        for (size_t b = 0; b < state.num_books; ++b) {
+            auto book = this->books_[b]->clone();
+            auto s = state.slot(b, l);
+            book->cash_ = state.cash[s];
+            book->_bind_symbols(symbols);
+            for (size_t a = 0; a < state.num_assets; ++a) {
+                auto p = state.position(b, a, l);
+                if (state.held[p])
+                    book->set_position(asset_names[a], state.positions[p]);
+            }
+            for (size_t d = 0; d < state.days.size(); ++d) {
+                auto h = (d * state.num_books + b) * L + l;
+                auto cash = state.history_cash[h], mtm = state.history_mtm[h];
+                book->_history_.push_back(
+                    {state.days[d], cash, mtm, cash + mtm});
+            }
+            result.books_.push_back(book);
+            lane_book_map->emplace(book->name_, book);
+        }
+
+        // orders in the order they were processed
+        for (auto &[order, b] : state.processed[l]) {
+            auto so = make_run_shared<SimpleOrder>(
+                asset_names[order.asset], order.size, order.size_type,
+                order.book_name, order.label);
+            so->book_ = result.books_[b];
+            so->status_ = OrderStatus::COMPLETE;
+            result.orders_processed_.push_back(so);
+        }
+
+        for (size_t b = 0; b < state.num_books; ++b) {
+            auto &book = result.books_[b];
+            for (auto &t : state.transactions[state.slot(b, l)]) {
+                if (t.order == kInterest) {
+                    book->ledger_.append_cash(
+                        t.ts, t.total,
+                        "interest payment on cash {self.cash:.2f}"s);
+                } else {
+                    auto &[order, _] = state.processed[l][t.order];
+                    book->ledger_.append(
+                        t.ts, TransactionKind::TRADE,
+                        symbols->id(asset_names[order.asset]), t.quantity,
+                        t.price, t.total, order.label);
+                }
+            }
+        }
+
+        // orders placed on the last close are left unprocessed
+        for (auto &order : orders.orders_) {
+            if (order.lane != l) continue;
+            result.orders_unprocessed_->push_back(make_run_shared<SimpleOrder>(
+                asset_names[order.asset], order.size, order.size_type,
+                order.book_name, order.label));
+        }
+
+        for (auto &s : strategies) {
+            auto strategy = s->clone();
+            strategy->params_ = params_vector[l];
+            strategy->asset_map_ = lane_asset_map;
+            strategy->book_map_ = lane_book_map;
+            strategy->orders_ = result.orders_unprocessed_;
+            strategy->indicators_ = indicators;
+            strategy->data_ = s->data_;
+            result.strategies_.push_back(strategy);
+        }
+    }
+
+    DLOG(INFO) << "Finished running strategy runner in lockstep";
+    return results;
+}
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,164 @@
+#include "YABTE/BackTest/Metrics.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+#include "YABTE/BackTest/Analytics.hpp"
+#include "YABTE/BackTest/StrategyRunner.hpp"
+
+namespace YABTE::BackTest {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// total of all books per day, books share the runner's calendar
+vector<double> equity(const StrategyRunnerResult &result) {
+    vector<double> values;
+    for (auto &book : result.books_) {
+        auto &history = book->_history_;
+        values.resize(std::max(values.size(), history.size()), 0.);
+        for (size_t d = 0; d < history.size(); ++d)
+            values[d] += std::get<3>(history[d]);
+    }
+    return values;
+}
+
+// the one implementation of the equity based ratios, see Analytics.hpp
+PerformanceStats performance(const StrategyRunnerResult &result) {
+    auto values = equity(result);
+    return ComputePerformance(values.data(), nullptr, values.size());
+}
+
+// builder for a parameter column, typed by the variant's alternative
+template <typename T>
+struct ParamBuilder;
+template <>
+struct ParamBuilder<double> {
+    using type = arrow::DoubleBuilder;
+};
+template <>
+struct ParamBuilder<string> {
+    using type = arrow::StringBuilder;
+};
+template <>
+struct ParamBuilder<bool> {
+    using type = arrow::BooleanBuilder;
+};
+template <>
+struct ParamBuilder<int> {
+    using type = arrow::Int32Builder;
+};
+
+template <typename T>
+shared_ptr<arrow::Array> param_column(const vector<ParamMap> &params_vector,
+                                      const string &name) {
+    typename ParamBuilder<T>::type builder;
+    for (auto &params : params_vector) {
+        auto it = params.find(name);
+        if (it == params.end()) {
+            CHECK(builder.AppendNull().ok());
+            continue;
+        }
+        auto value = std::get_if<T>(&it->second);
+        if (!value) {
+            throw std::runtime_error("Parameter has mixed types: " + name);
+        }
+        CHECK(builder.Append(*value).ok());
+    }
+    auto st_a = builder.Finish();
+    CHECK(st_a.ok()) << "Error: " << st_a.status();
+    return st_a.ValueOrDie();
+}
+
+}  // namespace
+
+namespace Metrics {
+
+double final_equity(const StrategyRunnerResult &result) {
+    auto values = equity(result);
+    return values.empty() ? kNaN : values.back();
+}
+
+double sharpe_ratio(const StrategyRunnerResult &result) {
+    return performance(result).sharpe_ratio;
+}
+
+double max_drawdown(const StrategyRunnerResult &result) {
+    return performance(result).max_drawdown;
+}
+
+double trade_count(const StrategyRunnerResult &result) {
+    int64_t count = 0;
+    for (auto &book : result.books_) count += book->ledger_.num_trades();
+    return count;
+}
+
+const MetricVector &builtin() {
+    static const MetricVector metrics = {{"final_equity", final_equity},
+                                         {"sharpe_ratio", sharpe_ratio},
+                                         {"max_drawdown", max_drawdown},
+                                         {"trade_count", trade_count}};
+    return metrics;
+}
+
+Metric by_name(const string &name) {
+    for (auto &[n, metric] : builtin()) {
+        if (n == name) return metric;
+    }
+    throw std::out_of_range("Metric not found: " + name);
+}
+
+}  // namespace Metrics
+
+shared_ptr<Table> SummaryTable(const vector<ParamMap> &params_vector,
+                               const vector<string> &metric_names,
+                               const vector<vector<double>> &values) {
+    arrow::FieldVector fields;
+    arrow::ArrayVector columns;
+
+    // parameter columns, typed by first set that has the parameter
+    std::set<string> names;
+    for (auto &params : params_vector)
+        for (auto &[name, _] : params) names.insert(name);
+
+    for (auto &name : names) {
+        auto first = std::find_if(
+            params_vector.begin(), params_vector.end(),
+            [&](auto &params) { return params.count(name) > 0; });
+        auto column = std::visit(
+            [&](auto &&v) {
+                using T = std::decay_t<decltype(v)>;
+                return param_column<T>(params_vector, name);
+            },
+            first->at(name));
+        fields.push_back(arrow::field(name, column->type()));
+        columns.push_back(column);
+    }
+
+    // metric columns
+    for (size_t k = 0; k < metric_names.size(); ++k) {
+        if (names.count(metric_names[k])) {
+            throw std::runtime_error("Metric clashes with parameter: " +
+                                     metric_names[k]);
+        }
+        arrow::DoubleBuilder builder;
+        for (auto &row : values) CHECK(builder.Append(row[k]).ok());
+        auto st_a = builder.Finish();
+        CHECK(st_a.ok()) << "Error: " << st_a.status();
+        fields.push_back(arrow::field(metric_names[k], arrow::float64()));
+        columns.push_back(st_a.ValueOrDie());
+    }
+
+    return Table::Make(arrow::schema(fields), columns,
+                       static_cast<int64_t>(params_vector.size()));
+}
+
+}  // namespace YABTE::BackTest
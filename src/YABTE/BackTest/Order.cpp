@@ -3,6 +3,7 @@
 #include <glog/logging.h>
 
 #include <stdexcept>
+#include <typeinfo>
 
 using std::runtime_error, std::make_shared;
 
@@ -19,8 +20,7 @@ Order::Order(const optional<string>& book_name, const optional<string>& label,
 void Order::_book_trades(const vector<shared_ptr<Trade>> trades) {
     // test then book trades, do any post complete tasks
     if (this->book_->test_trades(trades)) {
-        TransactionVector transactions(trades.begin(), trades.end());
-        this->book_->add_transactions(transactions);
+        this->book_->add_trades(trades);
         this->status_ = OrderStatus::COMPLETE;
         this->post_complete(trades);
     } else {
@@ -41,11 +41,12 @@ SimpleOrder::SimpleOrder(const string& asset_name, const double& size,
       size_type_(size_type) {}
 
 tuple<double, double> SimpleOrder::_calc_quantity_price(
-    const DayData& day_data, const AssetMap& asset_map) const {
-    auto asset = asset_map.at(this->asset_name_);
-    auto asset_day_data = asset->_filter_data(day_data);
-    auto trade_price =
-        asset->intraday_traded_price(*asset_day_data, this->size_);
+    const DayView& day_data, const AssetMap& asset_map) const {
+    auto& asset = this->asset_id_ != NO_ASSET_ID
+                      ? asset_map.at(this->asset_id_)
+                      : asset_map.at(this->asset_name_);
+    if (!asset) throw runtime_error("Asset not found: " + this->asset_name_);
+    auto trade_price = asset->intraday_traded_price(day_data, this->size_);
 
     if (this->size_type_ == OrderSizeType::QUANTITY)
         return {asset->round_quantity(this->size_), trade_price};
@@ -64,13 +65,16 @@ optional<OrderStatus> SimpleOrder::pre_execute_check(const Timestamp& ts,
     return nullopt;
 }
 
-void SimpleOrder::apply(const Timestamp& ts, const DayData& day_data,
+void SimpleOrder::apply(const Timestamp& ts, const DayView& day_data,
                         const AssetMap& asset_map) {
     DLOG(INFO) << "SimpleOrder::apply()";
     if (!this->book_) {
         throw runtime_error("Book not found");
     }
 
+    if (this->asset_id_ == NO_ASSET_ID)
+        this->asset_id_ = asset_map.symbols_->id(this->asset_name_);
+
     auto [trade_quantity, trade_price] =
         this->_calc_quantity_price(day_data, asset_map);
 
@@ -80,10 +84,25 @@ void SimpleOrder::apply(const Timestamp& ts, const DayData& day_data,
         return;
     }
 
-    vector<shared_ptr<Trade>> trades;
-    trades.push_back(make_shared<Trade>(ts, trade_quantity, trade_price,
-                                        this->asset_name_, this->label_));
-    this->_book_trades(trades);
+    // a plain SimpleOrder has nothing in post_complete, so its fill goes
+    // straight to the book's ledger without making a Trade. subclasses may
+    // override post_complete and book a Trade as other orders do.
+    if (typeid(*this) == typeid(SimpleOrder)) {
+        if (!this->book_->test_fill(this->asset_id_, trade_quantity)) {
+            this->status_ = OrderStatus::MANDATE_FAILED;
+            return;
+        }
+        this->book_->_add_fill(ts, this->asset_id_, trade_quantity,
+                               trade_price, -trade_quantity * trade_price,
+                               this->label_);
+        this->status_ = OrderStatus::COMPLETE;
+        return;
+    }
+
+    auto trade = make_shared<Trade>(ts, trade_quantity, trade_price,
+                                    this->asset_name_, this->label_);
+    trade->asset_id_ = this->asset_id_;
+    this->_book_trades({trade});
 }
 
 shared_ptr<Order> SimpleOrder::clone() const {
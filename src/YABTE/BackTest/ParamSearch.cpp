@@ -0,0 +1,264 @@
+#include "YABTE/BackTest/ParamSearch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "YABTE/BackTest/Metrics.hpp"
+
+namespace YABTE::BackTest {
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// number of values a choice or int range can take, 0 for doubles
+int64_t num_values(const ParamDomain &domain) {
+    if (auto r = std::get_if<IntRange>(&domain))
+        return (r->high - r->low) / r->step + 1;
+    if (auto c = std::get_if<Choice>(&domain))
+        return static_cast<int64_t>(c->values.size());
+    return 0;
+}
+
+// index of the value at u in [0, 1] among n
+int64_t value_index(const double u, const int64_t n) {
+    return std::clamp<int64_t>(static_cast<int64_t>(u * n), 0, n - 1);
+}
+
+void check_domain(const string &name, const ParamDomain &domain) {
+    auto invalid = [&](const string &what) {
+        throw std::invalid_argument("Invalid search domain " + name + ": " +
+                                    what);
+    };
+    if (auto r = std::get_if<IntRange>(&domain)) {
+        if (r->step <= 0) invalid("step must be positive");
+        if (r->high < r->low) invalid("high below low");
+    } else if (auto r = std::get_if<DoubleRange>(&domain)) {
+        if (!(r->high >= r->low)) invalid("high below low");
+        if (r->log && r->low <= 0.) invalid("log range must be positive");
+    } else if (std::get<Choice>(domain).values.empty()) {
+        invalid("no choices");
+    }
+}
+
+// parzen estimator on [0, 1]: a gaussian per point plus a uniform prior
+// weighted as one more point. each point's bandwidth is the larger gap to
+// its neighbours (the bounds at the ends), as in hyperopt, so sparse
+// regions stay wide and are still explored.
+struct Parzen {
+    explicit Parzen(vector<double> xs) : xs_(std::move(xs)) {
+        std::sort(this->xs_.begin(), this->xs_.end());
+        auto n = std::ssize(this->xs_);
+        auto min_sigma = 1. / std::min<double>(100., n + 1.);
+        for (int64_t i = 0; i < n; ++i) {
+            auto left = this->xs_[i] - (i > 0 ? this->xs_[i - 1] : 0.);
+            auto right = (i + 1 < n ? this->xs_[i + 1] : 1.) - this->xs_[i];
+            this->sigmas_.push_back(
+                std::clamp(std::max(left, right), min_sigma, 1.));
+        }
+    }
+
+    // a point plus noise, or the prior
+    double sample(std::mt19937_64 &rng) const {
+        std::uniform_int_distribution<size_t> pick(0, this->xs_.size());
+        std::uniform_real_distribution<double> uniform;
+        auto j = pick(rng);
+        if (j == this->xs_.size()) return uniform(rng);
+        std::normal_distribution<double> noise(this->xs_[j], this->sigmas_[j]);
+        return std::clamp(noise(rng), 0., 1.);
+    }
+
+    double log_density(const double x) const {
+        constexpr double kInvSqrt2Pi = 0.3989422804014327;
+        auto sum = 1.;
+        for (size_t i = 0; i < this->xs_.size(); ++i) {
+            auto z = (x - this->xs_[i]) / this->sigmas_[i];
+            sum += kInvSqrt2Pi / this->sigmas_[i] * std::exp(-0.5 * z * z);
+        }
+        return std::log(sum / (this->xs_.size() + 1));
+    }
+
+    vector<double> xs_;
+    vector<double> sigmas_;
+};
+
+}  // namespace
+
+shared_ptr<Table> SearchResult::summary(const string &objective) const {
+    vector<vector<double>> rows;
+    for (auto value : this->values_) rows.push_back({value});
+    return SummaryTable(this->params_, {objective}, rows);
+}
+
+ParamSearch::ParamSearch(const ParamSpace &space,
+                         const SearchOptions &options)
+    : options_(options), rng_(options.seed) {
+    if (options.num_trials < 0)
+        throw std::invalid_argument("Negative number of trials");
+    if (!(options.gamma > 0. && options.gamma < 1.))
+        throw std::invalid_argument("TPE gamma must be in (0, 1)");
+
+    for (auto &[name, domain] : space) {
+        check_domain(name, domain);
+        this->names_.push_back(name);
+        this->domains_.push_back(domain);
+    }
+
+    auto n = options.num_trials;
+    if (options.method == SearchMethod::TPE)
+        n = std::min(n, std::max<int64_t>(options.startup_trials, 0));
+
+    std::uniform_real_distribution<double> uniform;
+    this->design_.assign(n, Point(this->domains_.size()));
+    for (size_t d = 0; d < this->domains_.size(); ++d) {
+        if (options.method == SearchMethod::RANDOM) {
+            for (auto &point : this->design_) point[d] = uniform(this->rng_);
+            continue;
+        }
+        vector<int64_t> strata(n);
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), this->rng_);
+        for (int64_t i = 0; i < n; ++i) {
+            this->design_[i][d] =
+                (static_cast<double>(strata[i]) + uniform(this->rng_)) / n;
+        }
+    }
+
+    this->points_.resize(options.num_trials);
+    this->values_.assign(options.num_trials, std::nan(""));
+    this->asked_.assign(options.num_trials, false);
+    this->told_.assign(options.num_trials, false);
+}
+
+ParamMap ParamSearch::ask(const int64_t trial) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    if (trial < 0 || trial >= this->options_.num_trials)
+        throw std::out_of_range("Trial out of range");
+
+    auto &point = this->points_[trial];
+    if (!this->asked_[trial]) {
+        point = trial < std::ssize(this->design_) ? this->design_[trial]
+                                                  : this->_tpe_point();
+        this->asked_[trial] = true;
+    }
+    return this->_decode(point);
+}
+
+void ParamSearch::tell(const int64_t trial, const double value) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    if (trial < 0 || trial >= this->options_.num_trials ||
+        !this->asked_[trial])
+        throw std::out_of_range("Trial not asked");
+    this->values_[trial] = value;
+    this->told_[trial] = true;
+}
+
+SearchResult ParamSearch::result() const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    SearchResult result;
+    for (int64_t i = 0; i < this->options_.num_trials; ++i) {
+        if (!this->told_[i]) continue;
+        auto value = this->values_[i];
+        if (!std::isnan(value)) {
+            auto best = result.best_ < 0 ? std::nan("")
+                                         : result.values_[result.best_];
+            if (std::isnan(best) ||
+                (this->options_.maximize ? value > best : value < best))
+                result.best_ = std::ssize(result.values_);
+        }
+        result.params_.push_back(this->_decode(this->points_[i]));
+        result.values_.push_back(value);
+    }
+    return result;
+}
+
+ParamSearch::Point ParamSearch::_tpe_point() {
+    std::uniform_real_distribution<double> uniform;
+    Point point(this->domains_.size());
+
+    // told trials, best first
+    vector<int64_t> done;
+    for (int64_t i = 0; i < this->options_.num_trials; ++i)
+        if (this->told_[i]) done.push_back(i);
+    auto n = std::ssize(done);
+    if (n < 2) {
+        for (auto &u : point) u = uniform(this->rng_);
+        return point;
+    }
+
+    auto maximize = this->options_.maximize;
+    std::stable_sort(done.begin(), done.end(), [&](auto a, auto b) {
+        auto va = this->values_[a], vb = this->values_[b];
+        if (std::isnan(vb)) return !std::isnan(va);
+        if (std::isnan(va)) return false;
+        return maximize ? va > vb : va < vb;
+    });
+    auto n_good = std::clamp<int64_t>(
+        static_cast<int64_t>(std::ceil(this->options_.gamma * n)), 1, n - 1);
+
+    for (size_t d = 0; d < this->domains_.size(); ++d) {
+        vector<double> good, bad;
+        for (int64_t k = 0; k < n; ++k) {
+            (k < n_good ? good : bad).push_back(this->points_[done[k]][d]);
+        }
+
+        auto best_score = -kInf;
+        if (std::holds_alternative<Choice>(this->domains_[d])) {
+            auto k = num_values(this->domains_[d]);
+            // smoothed frequencies of each choice in either group
+            vector<double> l(k, 1.), g(k, 1.);
+            for (auto u : good) l[value_index(u, k)] += 1.;
+            for (auto u : bad) g[value_index(u, k)] += 1.;
+            std::discrete_distribution<int64_t> draw(l.begin(), l.end());
+            for (int c = 0; c < this->options_.num_candidates; ++c) {
+                auto i = draw(this->rng_);
+                auto score = std::log(l[i] / (n_good + k)) -
+                             std::log(g[i] / (n - n_good + k));
+                if (score > best_score) {
+                    best_score = score;
+                    point[d] = (i + 0.5) / k;
+                }
+            }
+        } else {
+            Parzen l(good), g(bad);
+            for (int c = 0; c < this->options_.num_candidates; ++c) {
+                auto x = l.sample(this->rng_);
+                auto score = l.log_density(x) - g.log_density(x);
+                if (score > best_score) {
+                    best_score = score;
+                    point[d] = x;
+                }
+            }
+        }
+        if (best_score == -kInf) point[d] = uniform(this->rng_);
+    }
+    return point;
+}
+
+ParamMap ParamSearch::_decode(const Point &point) const {
+    ParamMap params;
+    for (size_t d = 0; d < this->domains_.size(); ++d) {
+        auto u = point[d];
+        auto &domain = this->domains_[d];
+        if (auto r = std::get_if<IntRange>(&domain)) {
+            params[this->names_[d]] =
+                r->low +
+                static_cast<int>(value_index(u, num_values(domain))) * r->step;
+        } else if (auto r = std::get_if<DoubleRange>(&domain)) {
+            params[this->names_[d]] =
+                r->log ? std::exp(std::log(r->low) +
+                                  u * (std::log(r->high) - std::log(r->low)))
+                       : r->low + u * (r->high - r->low);
+        } else {
+            auto &values = std::get<Choice>(domain).values;
+            params[this->names_[d]] =
+                values[value_index(u, std::ssize(values))];
+        }
+    }
+    return params;
+}
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,211 @@
+#include <glog/logging.h>
+#include <poll.h>
+#include <pybind11/embed.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+
+#include "YABTE/BackTest/StrategyRunner.hpp"
+#include "YABTE/Utilities/Arrow/SharedMemory.hpp"
+
+using std::make_shared;
+
+using YABTE::Utilities::Arrow::SharedTable;
+
+namespace YABTE::BackTest {
+
+namespace {
+
+// a worker's row: the parameter set's index then its metric values
+struct RecordLayout {
+    size_t num_metrics;
+    size_t size() const {
+        return sizeof(int64_t) + this->num_metrics * sizeof(double);
+    }
+};
+
+bool write_all(const int fd, const char* data, size_t size) {
+    while (size > 0) {
+        auto n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+}  // namespace
+
+shared_ptr<Table> StrategyRunner::run_batch_summary_processes(
+    const vector<ParamMap>& params_vector, const MetricVector& metrics,
+    const optional<unsigned int> num_processes) {
+    vector<string> metric_names;
+    for (auto& [name, _] : metrics) metric_names.push_back(name);
+    auto n = std::ssize(params_vector);
+    vector<vector<double>> values(n);
+    if (n == 0) return SummaryTable(params_vector, metric_names, values);
+
+    auto st_st = SharedTable::Publish(this->_day_table()->table_);
+    CHECK(st_st.ok()) << "Error: " << st_st.status();
+    auto shared = st_st.ValueOrDie();
+
+    auto num_workers = std::min<int64_t>(
+        n, std::max(1u, num_processes.value_or(
+                            std::thread::hardware_concurrency())));
+    RecordLayout layout{metrics.size()};
+
+    // fork copies only this thread, any lock another thread (an executor
+    // worker, arrow's thread pool, glog) holds stays locked in the child,
+    // so the child touches none of them: see _process_worker. the forking
+    // thread holds the GIL, so the children's interpreters start from a
+    // consistent state.
+    vector<pid_t> pids;
+    vector<int> fds;
+    auto py = Py_IsInitialized();
+    {
+        std::optional<pybind11::gil_scoped_acquire> gil;
+        if (py) gil.emplace();
+        for (int64_t w = 0; w < num_workers; ++w) {
+            int pipe_fds[2];
+            if (pipe(pipe_fds) != 0) break;
+            if (py) PyOS_BeforeFork();
+            auto pid = fork();
+            if (pid == 0) {
+                if (py) PyOS_AfterFork_Child();
+                close(pipe_fds[0]);
+                for (auto fd : fds) close(fd);
+                _exit(this->_process_worker(shared->name(), params_vector,
+                                            metrics, w, num_workers,
+                                            pipe_fds[1]));
+            }
+            if (py) PyOS_AfterFork_Parent();
+            close(pipe_fds[1]);
+            if (pid < 0) {
+                close(pipe_fds[0]);
+                break;
+            }
+            pids.push_back(pid);
+            fds.push_back(pipe_fds[0]);
+        }
+    }
+
+    // read whichever pipes have data so no worker blocks on a full pipe,
+    // keeping each pipe's partial record until the rest of it arrives
+    int64_t received = 0;
+    auto corrupt = false;
+    vector<pollfd> polls;
+    for (auto fd : fds) polls.push_back({fd, POLLIN, 0});
+    vector<vector<char>> partial(polls.size());
+    vector<char> chunk(64 << 10);
+    auto open = std::ssize(polls);
+    while (open > 0) {
+        if (poll(polls.data(), polls.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            corrupt = true;
+            break;
+        }
+        for (size_t w = 0; w < polls.size(); ++w) {
+            auto& p = polls[w];
+            // poll skips the negative fds of closed pipes
+            if (p.fd < 0 || p.revents == 0) continue;
+            auto got = read(p.fd, chunk.data(), chunk.size());
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {
+                close(p.fd);
+                p.fd = -1;
+                --open;
+                continue;
+            }
+
+            auto& buffer = partial[w];
+            buffer.insert(buffer.end(), chunk.data(), chunk.data() + got);
+            size_t at = 0;
+            for (; buffer.size() - at >= layout.size(); at += layout.size()) {
+                int64_t i;
+                std::memcpy(&i, buffer.data() + at, sizeof(i));
+                if (i < 0 || i >= n || !values[i].empty()) {
+                    corrupt = true;
+                    continue;
+                }
+                values[i].resize(metrics.size());
+                std::memcpy(values[i].data(), buffer.data() + at + sizeof(i),
+                            metrics.size() * sizeof(double));
+                ++received;
+            }
+            buffer.erase(buffer.begin(), buffer.begin() + at);
+        }
+    }
+    for (auto& p : polls) {
+        if (p.fd >= 0) close(p.fd);
+    }
+    for (auto& buffer : partial) corrupt = corrupt || !buffer.empty();
+
+    auto failed = corrupt || std::ssize(pids) < num_workers;
+    for (auto pid : pids) {
+        int status;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed = true;
+    }
+    if (failed || received != n)
+        throw std::runtime_error("Batch worker process failed");
+
+    return SummaryTable(params_vector, metric_names, values);
+}
+
+int StrategyRunner::_process_worker(const string& data_name,
+                                    const vector<ParamMap>& params_vector,
+                                    const MetricVector& metrics,
+                                    const int64_t first, const int64_t stride,
+                                    const int fd) {
+    // only this thread was forked, so this avoids what the parent's other
+    // threads may have held locked: the data is mapped without arrow's
+    // thread pool, the runner gets its own caches, _run is single threaded
+    // (Executor::shared() would be a fresh one in this process) and the
+    // run's errors are exceptions reported straight to stderr. glog isn't
+    // fork safe and is still reached by DLOG in debug builds, a strategy's
+    // own logging and a failing arrow builder CHECK, any of which can hang
+    // the worker if another parent thread was logging when it forked.
+    try {
+        auto st_table = SharedTable::Map(data_name);
+        if (!st_table.ok())
+            throw std::runtime_error(st_table.status().ToString());
+        this->data_ = st_table.ValueOrDie();
+        this->indicator_cache_ = nullptr;
+        this->day_table_cache_ = make_shared<DayTableCache>();
+        auto indicators = make_shared<IndicatorCache>();
+
+        std::pmr::unsynchronized_pool_resource pool(
+            std::pmr::pool_options{0, 4 << 20});
+        RecordLayout layout{metrics.size()};
+        vector<char> record(layout.size());
+
+        for (auto i = first; i < std::ssize(params_vector); i += stride) {
+            auto result = this->_run(params_vector[i], indicators, &pool);
+            std::memcpy(record.data(), &i, sizeof(i));
+            auto out = record.data() + sizeof(i);
+            for (auto& [_, metric] : metrics) {
+                auto value = metric(result);
+                std::memcpy(out, &value, sizeof(value));
+                out += sizeof(value);
+            }
+            if (!write_all(fd, record.data(), record.size())) return 1;
+        }
+    } catch (const std::exception& e) {
+        auto message =
+            string("Batch worker process failed: ") + e.what() + "\n";
+        write_all(STDERR_FILENO, message.data(), message.size());
+        return 1;
+    }
+    close(fd);
+    return 0;
+}
+
+}  // namespace YABTE::BackTest
@@ -0,0 +1,135 @@
+#include <glog/logging.h>
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+
+#include "YABTE/BackTest/StrategyRunner.hpp"
+
+using std::make_shared;
+
+namespace YABTE::BackTest {
+
+StrategyRunnerResult StrategyRunner::run_signals(
+    const ParamMap &params, const SignalOptions &options) {
+    DLOG(INFO) << "Running strategy runner on signals";
+    auto indicators = this->indicator_cache_ ? this->indicator_cache_
+                                             : make_shared<IndicatorCache>();
+    // strategies only extend the data, init is still called
+    auto state = this->_start(params, indicators);
+    auto &result = state.result_;
+    ArenaScope arena_scope(result.arena_);
+    auto &asset_map = *state.asset_map_;
+
+    auto day_view = this->_day_table();
+    auto &day_table = *day_view;
+    auto date_index = day_table.column_index("Date");
+    CHECK(date_index >= 0) << "Error: Date column not found";
+    auto &calendar = day_table.column(date_index);
+    auto num_rows = day_table.num_rows();
+
+    // signals as one contiguous array, [asset id][row], NaN for nulls and
+    // for assets without a signal column. strategies' columns come first.
+    vector<const TableView *> views;
+    for (auto &strategy : result.strategies_)
+        views.push_back(&strategy->data_->view_);
+    views.push_back(&day_table);
+
+    auto num_assets = asset_map.by_id_.size();
+    vector<double> signals(num_assets * num_rows, std::nan(""));
+    size_t found = 0;
+    for (size_t a = 0; a < num_assets; ++a) {
+        auto &asset = *asset_map.by_id_[a];
+        for (auto view : views) {
+            ColumnPlan plan(view->table_->schema());
+            auto column = plan.find(asset.data_label_, options.field);
+            if (!column.resolved()) continue;
+            CHECK(view->num_rows() == num_rows)
+                << "Error: signal column rows differ from the data's";
+            auto &col = view->column(column.index);
+            auto out = signals.data() + a * num_rows;
+            for (int64_t i = 0; i < num_rows; ++i) out[i] = col.as_double(i);
+            ++found;
+            break;
+        }
+    }
+    if (found == 0) {
+        throw std::runtime_error("No signal columns for field " +
+                                 options.field);
+    }
+
+    auto book_ptr = options.book_name.has_value()
+                        ? state.book_map_->at(options.book_name.value())
+                        : result.books_[0];
+    auto &book = *book_ptr;
+    auto target = options.kind == SignalKind::TARGET_POSITION;
+
+    // sizes of the orders placed at the last close by asset id, NaN when
+    // none, and every filled order's asset and size
+    vector<double> pending(num_assets, std::nan(""));
+    vector<std::tuple<AssetId, double>> filled;
+
+    for (int64_t i = 0; i < num_rows; ++i) {
+        if (!calendar.is_valid(i)) continue;
+
+        auto ts_chrono =
+            timestamp_from_ns(calendar.value<arrow::TimestampType::c_type>(i));
+        DayView day_data(day_table, i);
+
+        // open, fill as SimpleOrder::apply then Book::add_trades
+        for (size_t a = 0; a < num_assets; ++a) {
+            auto size = pending[a];
+            if (std::isnan(size)) continue;
+            auto &asset = *asset_map.by_id_[a];
+            auto id = static_cast<AssetId>(a);
+            auto price = asset.intraday_traded_price(day_data, size);
+            auto quantity = asset.round_quantity(size);
+            auto total = -quantity * price;
+            book._position(id) += quantity;
+            book.cash_ += total;
+            book.ledger_.append(ts_chrono, TransactionKind::TRADE, id,
+                                quantity, price, total, nullopt);
+            filled.emplace_back(id, size);
+            pending[a] = std::nan("");
+        }
+
+        // close, positions_ covers every asset id once symbols are bound
+        for (size_t a = 0; a < num_assets; ++a) {
+            auto signal = signals[a * num_rows + i];
+            if (std::isnan(signal)) continue;
+            auto size = target ? signal - book.positions_[a] : signal;
+            if (size != 0.) pending[a] = size;
+        }
+
+        // run book end-of-day tasks
+        for (auto &b : result.books_)
+            b->eod_tasks(ts_chrono, day_data, asset_map);
+    }
+    state.next_row_ = num_rows;
+
+    // orders for the result, in fill order
+    auto order = [&](const AssetId id, const double size) {
+        return make_run_shared<SimpleOrder>(
+            asset_map.symbols_->name(id), size, OrderSizeType::QUANTITY,
+            options.book_name);
+    };
+    for (auto [id, size] : filled) {
+        auto so = order(id, size);
+        so->book_ = book_ptr;
+        so->asset_id_ = id;
+        so->status_ = OrderStatus::COMPLETE;
+        result.orders_processed_.push_back(so);
+    }
+    // orders placed on the last close are left unprocessed
+    for (size_t a = 0; a < num_assets; ++a) {
+        if (!std::isnan(pending[a]))
+            result.orders_unprocessed_->push_back(
+                order(static_cast<AssetId>(a), pending[a]));
+    }
+
+    DLOG(INFO) << "Finished running strategy runner on signals";
+    return std::move(result);
+}
+
+}  // namespace YABTE::BackTest
@@ -1,5 +1,7 @@
 #include "YABTE/BackTest/Strategy.hpp"
 
+#include <stdexcept>
+
 namespace YABTE::BackTest {
 
 template <class Var, class>
@@ -26,4 +28,13 @@ shared_ptr<const Table> Strategy::extend_data(
     return nullptr;
 }
 
+int64_t Strategy::lookback() const { return 0; }
+
+int64_t Strategy::block_size() const { return 1; }
+
+std::vector<std::vector<shared_ptr<Order>>> Strategy::on_close_block(
+    const int64_t begin, const int64_t end) {
+    throw std::logic_error("on_close_block not implemented");
+}
+
 }  // namespace YABTE::BackTest
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include "YABTE/BackTest/StrategyRunner.hpp"
 
-#include <BS_thread_pool.hpp>
-#include <ranges>
-#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <memory_resource>
+#include <numeric>
+#include <stdexcept>
 #include <utility>
 
 #include "YABTE/Utilities/Arrow/TableHelpers.hpp"
@@ -10,10 +12,11 @@
 #include "YABTE/Utilities/Python/Interpreters.hpp"
 #endif
 
-using std::dynamic_pointer_cast, std::make_shared;
+using std::make_shared;
 
 using YABTE::Utilities::Arrow::ExtendTable,
     YABTE::Utilities::Arrow::HorizConcatTables;
+using YABTE::Utilities::Concurrency::WorkerLocal;
 
 #ifdef EXPER_PY_SUB_INTERP
 using YABTE::Utilities::Python::ThreadsAllowedScope;
@@ -25,9 +28,154 @@ namespace YABTE::BackTest {
 thread_local SubInterpreter subinterp_;
 #endif
 
+namespace {
+
+// the data with the strategy's extended columns, if any
+shared_ptr<Table> strategy_data(Strategy& strategy,
+                                const shared_ptr<Table>& data) {
+    // merge tables here (using pointers to avoid copying data)
+    auto new_data = strategy.extend_data(data);
+    if (!new_data) {
+        DLOG(INFO) << "Not extending data for strategy";
+        return data;
+    }
+    DLOG(INFO) << "Extending data for strategy";
+    auto st_et = ExtendTable(data, new_data);
+    if (!st_et.ok())
+        throw std::runtime_error("Error: " + st_et.status().ToString());
+    return st_et.ValueOrDie();
+}
+
+// whether row of a stream window's data matches prev_row of the previous
+// window's, where the row had every earlier row before it. columns that
+// need more rows than a strategy's lookback() (e.g. an exponential
+// average) differ at the row with just that many rows before it.
+bool same_row(const Table& prev, const int64_t prev_row, const Table& data,
+              const int64_t row) {
+    auto options = arrow::EqualOptions::Defaults().nans_equal(true);
+    for (auto& field : data.schema()->fields()) {
+        auto prev_column = prev.GetColumnByName(field->name());
+        if (!prev_column) return false;
+        auto st_gp = prev_column->GetScalar(prev_row);
+        auto st_gs = data.GetColumnByName(field->name())->GetScalar(row);
+        CHECK(st_gp.ok() && st_gs.ok()) << "Error: row out of range";
+        if (!st_gp.ValueOrDie()->Equals(*st_gs.ValueOrDie(), options))
+            return false;
+    }
+    return true;
+}
+
+// orders placed for the next day, reused across days of a run
+using OrderScratch = std::pmr::vector<shared_ptr<Order>>;
+
+// start the strategy's close blocks, after init so block_size() may use
+// the params
+void start_close_block(Strategy& strategy) {
+    auto size = strategy.block_size();
+    strategy.close_block_ = {.size = size > 1 ? size : 0};
+}
+
+// queue the strategy's orders for the close of row size - 1, calling
+// on_close_block first when the row starts a new block. a block ends
+// early at the last row the window holds (the end of a stream batch).
+void close_block(Strategy& strategy, const int64_t size) {
+    auto& block = strategy.close_block_;
+    auto row = size - 1;
+    if (row < block.begin || row - block.begin >= std::ssize(block.orders)) {
+        auto& window = *strategy.data_;
+        auto end = std::min(row + block.size,
+                            window.base() + window.view_.num_rows());
+        window.advance_to(end);
+        block.orders = strategy.on_close_block(row, end);
+        window.advance_to(size);
+        block.begin = row;
+        if (std::ssize(block.orders) != end - row)
+            throw std::runtime_error(
+                "Error: on_close_block returned " +
+                std::to_string(block.orders.size()) + " rows of orders for " +
+                std::to_string(end - row) + " rows");
+    }
+    auto& orders = block.orders[row - block.begin];
+    strategy.orders_->insert(strategy.orders_->end(), orders.begin(),
+                             orders.end());
+    orders.clear();
+}
+
+// one day of the event loop, strategies see size rows of data
+void run_day(StrategyRunnerResult& result, const AssetMap& asset_map,
+             const BookMap& book_map, const Timestamp& ts_chrono,
+             const DayView& day_data, const int64_t size,
+             OrderScratch& orders_next_ts) {
+    auto& default_book = result.books_[0];
+    orders_next_ts.clear();
+
+    // open
+    for (auto& strategy : result.strategies_) {
+        // TODO: mask out non-open available data
+        strategy->data_->advance_to(size);
+        strategy->on_open();
+    }
+
+    // process orders
+    while (!result.orders_unprocessed_->empty()) {
+        auto order = result.orders_unprocessed_->front();
+        result.orders_unprocessed_->pop_front();
+
+        // set book attribute if needed
+        if (!order->book_) {
+            if (order->book_name_.has_value()) {
+                order->book_ = book_map.at(order->book_name_.value());
+            } else {
+                // fall back to first available book
+                order->book_ = default_book;
+            }
+        }
+
+        order->apply(ts_chrono, day_data, asset_map);
+
+        // add any child orders to next ts
+        orders_next_ts.insert(orders_next_ts.end(), order->suborders_.begin(),
+                              order->suborders_.end());
+
+        result.orders_processed_.push_back(order);
+    }
+
+    // extend with orders for next ts
+    result.orders_unprocessed_->insert(result.orders_unprocessed_->end(),
+                                       orders_next_ts.begin(),
+                                       orders_next_ts.end());
+
+    // close
+    for (auto& strategy : result.strategies_) {
+        if (strategy->close_block_.size)
+            close_block(*strategy, size);
+        else
+            strategy->on_close();
+    }
+
+    // run book end-of-day tasks
+    for (auto& book : result.books_) {
+        book->eod_tasks(ts_chrono, day_data, asset_map);
+    }
+}
+
+}  // namespace
+
 StrategyRunnerResult::StrategyRunnerResult()
     : orders_unprocessed_(make_shared<OrderDeque>()) {}
 
+ArenaStats StrategyRunnerResult::arena_stats() const {
+    return this->arena_ ? this->arena_->stats() : ArenaStats{};
+}
+
+shared_ptr<Table> HalvingResult::summary(const string& objective) const {
+    vector<vector<double>> rows;
+    for (size_t i = 0; i < this->values_.size(); ++i)
+        rows.push_back(
+            {this->values_[i], static_cast<double>(this->rows_[i])});
+    return SummaryTable(this->params_, {objective, "rows"}, rows);
+}
+
 shared_ptr<Table> StrategyRunnerResult::book_history() const {
     vector<string> book_names;
     vector<shared_ptr<const Table>> book_history_tables;
@@ -36,7 +184,8 @@ shared_ptr<Table> StrategyRunnerResult::book_history() const {
         book_history_tables.push_back(book->history());
     }
     auto st_et = HorizConcatTables(book_history_tables, book_names);
-    CHECK(st_et.ok()) << "Error: " << st_et.status();
+    if (!st_et.ok())
+        throw std::runtime_error("Error: " + st_et.status().ToString());
     return st_et.ValueOrDie();
 }
 
@@ -47,159 +196,380 @@ StrategyRunner::StrategyRunner(const shared_ptr<Table>& data,
     : data_(data), assets_(assets), strategies_(strategies), books_(books) {}
 
 StrategyRunnerResult StrategyRunner::run(const ParamMap& params) {
+    return this->_run(params, this->indicator_cache_
+                                  ? this->indicator_cache_
+                                  : make_shared<IndicatorCache>());
+}
+
+Executor& StrategyRunner::_executor() const {
+    return this->executor_ ? *this->executor_ : Executor::shared();
+}
+
+shared_ptr<const TableView> StrategyRunner::_day_table() const {
+    auto& cache = *this->day_table_cache_;
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (!cache.view || cache.data != this->data_) {
+        cache.view = make_shared<const TableView>(this->data_);
+        cache.data = this->data_;
+    }
+    return cache.view;
+}
+
+StrategyRunnerResult StrategyRunner::_run(
+    const ParamMap& params, const shared_ptr<IndicatorCache>& indicators,
+    std::pmr::memory_resource* arena_upstream) {
 #ifdef EXPER_PY_SUB_INTERP
     auto interp = subinterp_.interp();
     SubInterpreter::ThreadScope scope(interp);
 #endif
 
     DLOG(INFO) << "Running strategy runner";
-    StrategyRunnerResult result;
-
-    // copy books and stategies (assets are immutable but copy anyway)
-    for (auto& s : this->strategies_) {
-        result.strategies_.push_back(shared_ptr<Strategy>(s->clone()));
-    }
+    // chunks are combined once per data_ so each day is just a row index
+    // into the columns
+    auto day_table = this->_day_table();
+    auto state = this->_start(params, indicators, arena_upstream);
+    this->_advance(state, *day_table, day_table->num_rows());
 
-    for (auto& b : this->books_)
-        result.books_.push_back(shared_ptr<Book>(b->clone()));
+    DLOG(INFO) << "Finished running strategy runner";
+    return std::move(state.result_);
+}
 
-    for (auto& a : this->assets_)
-        result.assets_.push_back(shared_ptr<Asset>(a->clone()));
+RunState StrategyRunner::_start(const ParamMap& params,
+                                const shared_ptr<IndicatorCache>& indicators,
+                                std::pmr::memory_resource* arena_upstream) {
+    RunState state;
+    auto& result = state.result_;
+    result.arena_ = make_shared<RunArena>(64 * 1024, arena_upstream);
+    ArenaScope arena_scope(result.arena_);
+    std::tie(state.asset_map_, state.book_map_) =
+        this->_prepare(result, this->data_->schema());
+    state.params_ = params;
+
+    // init, strategies extend the runner's combined data so their windows
+    // only combine the columns they add
+    auto day_table = this->_day_table();
+    for (auto& strategy : result.strategies_) {
+        strategy->asset_map_ = state.asset_map_;
+        strategy->book_map_ = state.book_map_;
+        strategy->orders_ = result.orders_unprocessed_;
+        strategy->params_ = params;
+        strategy->indicators_ = indicators;
+        strategy->data_ = make_shared<DataWindow>(
+            strategy_data(*strategy, day_table->table_));
 
-    // generate asset and book maps
-    shared_ptr<AssetMap> asset_map = make_shared<AssetMap>();
-    shared_ptr<BookMap> book_map = make_shared<BookMap>();
-    for (auto a : result.assets_) asset_map->emplace(a->name_, a);
-    for (auto b : result.books_) book_map->emplace(b->name_, b);
+        // run strategy's init
+        strategy->init();
+        start_close_block(*strategy);
+    }
+    return state;
+}
 
-    auto default_book = result.books_[0];
+void StrategyRunner::_advance(RunState& state, const TableView& day_table,
+                              const int64_t end_row) const {
+    auto& result = state.result_;
+    ArenaScope arena_scope(result.arena_);
+    OrderScratch orders_next_ts(result.arena_.get());
 
-    auto calendar = this->data_->GetColumnByName("Date");
-    int64_t nr = this->data_->num_rows();
+    auto date_index = day_table.column_index("Date");
+    if (date_index < 0)
+        throw std::runtime_error("Error: Date column not found");
+    auto& calendar = day_table.column(date_index);
 
-    std::unordered_map<shared_ptr<Strategy>, shared_ptr<const Table>> data_map;
+    // run event loop
+    auto end = std::min(end_row, day_table.num_rows());
+    for (auto i = state.next_row_; i < end; ++i) {
+        if (!calendar.is_valid(i)) continue;
+
+        auto ts_chrono =
+            timestamp_from_ns(calendar.value<arrow::TimestampType::c_type>(i));
+        DayView day_data(day_table, i);
+        run_day(result, *state.asset_map_, *state.book_map_, ts_chrono,
+                day_data, i + 1, orders_next_ts);
+    }
+    state.next_row_ = std::max(state.next_row_, end);
+}
 
-    // init
+StrategyRunnerResult StrategyRunner::run_stream(
+    const shared_ptr<arrow::RecordBatchReader>& reader,
+    const ParamMap& params) {
+    DLOG(INFO) << "Running strategy runner over a stream";
+    StrategyRunnerResult result;
+    result.arena_ = make_shared<RunArena>();
+    ArenaScope arena_scope(result.arena_);
+    OrderScratch orders_next_ts(result.arena_.get());
+    auto [asset_map, book_map] = this->_prepare(result, reader->schema());
+
+    // init, strategies start with an empty window. extended columns are
+    // cached for a window only, as every window has new buffers.
+    auto st_me = Table::MakeEmpty(reader->schema());
+    CHECK(st_me.ok()) << "Error: " << st_me.status();
+    auto indicators = make_shared<IndicatorCache>();
+    int64_t lookback = 0;
     for (auto& strategy : result.strategies_) {
         strategy->asset_map_ = asset_map;
         strategy->book_map_ = book_map;
         strategy->orders_ = result.orders_unprocessed_;
         strategy->params_ = params;
-
-        // merge tables here (using pointers to avoid copying data)
-        auto new_data = strategy->extend_data(this->data_);
-        if (new_data) {
-            DLOG(INFO) << "Extending data for strategy";
-            auto st_et = ExtendTable(this->data_, new_data);
-            CHECK(st_et.ok()) << "Error: " << st_et.status();
-            data_map.insert(std::make_pair(
-                strategy, dynamic_pointer_cast<Table>(st_et.ValueOrDie())));
-        } else {
-            DLOG(INFO) << "Not extending data for strategy";
-            data_map.insert(std::make_pair(strategy, this->data_));
-        }
+        strategy->indicators_ = indicators;
+        strategy->data_ = make_shared<DataWindow>(st_me.ValueOrDie());
 
         // run strategy's init
         strategy->init();
+        start_close_block(*strategy);
+        lookback = std::max(lookback, strategy->lookback());
     }
 
-    // run event loop
-    for (const auto [i, ts] :
-         arrow::stl::Iterate<arrow::TimestampType>(*calendar) |
-             std::ranges::views::enumerate) {
-        if (!ts.has_value()) continue;
-
-        auto ts_chrono = timestamp_from_ns(*ts);
-        auto day_data = this->data_->Slice(i, 1);
+    // run event loop a batch at a time, each batch preceded by the last
+    // lookback + 1 rows of the data. the extra row checks the strategies'
+    // lookback against their extended columns.
+    int64_t seen = 0;
+    shared_ptr<Table> retained;
+    vector<bool> warned(result.strategies_.size(), false);
+    while (true) {
+        shared_ptr<arrow::RecordBatch> batch;
+        auto st_rn = reader->ReadNext(&batch);
+        CHECK(st_rn.ok()) << "Error: " << st_rn;
+        if (!batch) break;
+        if (batch->num_rows() == 0) continue;
+
+        auto st_fb = Table::FromRecordBatches({batch});
+        CHECK(st_fb.ok()) << "Error: " << st_fb.status();
+        auto window = st_fb.ValueOrDie();
+        int64_t held = 0;
+        if (retained) {
+            held = retained->num_rows();
+            auto st_ct = arrow::ConcatenateTables({retained, window});
+            CHECK(st_ct.ok()) << "Error: " << st_ct.status();
+            window = st_ct.ValueOrDie();
+        }
+        auto base = seen - held;
+
+        TableView day_table(window);
+        auto date_index = day_table.column_index("Date");
+        CHECK(date_index >= 0) << "Error: Date column not found";
+        auto& calendar = day_table.column(date_index);
+
+        indicators->clear();
+        for (size_t s = 0; s < result.strategies_.size(); ++s) {
+            auto& strategy = *result.strategies_[s];
+            auto& data = *strategy.data_;
+            auto extended = strategy_data(strategy, window);
+
+            // the held row with lookback() rows before it was also in the
+            // previous window, after all of the rows before it
+            if (held > 0 && extended != window && !warned[s]) {
+                auto row = std::min(strategy.lookback(), held - 1);
+                if (!same_row(*data.view_.table_, base + row - data.base(),
+                              *extended, row)) {
+                    LOG(WARNING) << "Strategy lookback of "
+                                 << strategy.lookback()
+                                 << " rows does not cover its extended "
+                                    "columns, run_stream will differ from run";
+                    warned[s] = true;
+                }
+            }
+            data.rebase(extended, base);
+        }
 
-        vector<shared_ptr<Order>> orders_next_ts;
+        for (int64_t i = held; i < day_table.num_rows(); ++i) {
+            if (!calendar.is_valid(i)) continue;
 
-        // open
-        for (auto& strategy : result.strategies_) {
-            // TODO: mask out non-open available data
-            strategy->data_ = data_map[strategy]->Slice(0, i + 1);
-            strategy->on_open();
+            auto ts_chrono = timestamp_from_ns(
+                calendar.value<arrow::TimestampType::c_type>(i));
+            DayView day_data(day_table, i);
+            run_day(result, *asset_map, *book_map, ts_chrono, day_data,
+                    base + i + 1, orders_next_ts);
         }
 
-        // process orders
-        while (!result.orders_unprocessed_->empty()) {
-            auto order = result.orders_unprocessed_->front();
-            result.orders_unprocessed_->pop_front();
-
-            // set book attribute if needed
-            if (!order->book_) {
-                if (order->book_name_.has_value()) {
-                    order->book_ = book_map->at(order->book_name_.value());
-                } else {
-                    // fall back to first available book
-                    order->book_ = default_book;
-                }
-            }
+        seen += batch->num_rows();
+        retained = window->Slice(
+            std::max<int64_t>(0, window->num_rows() - lookback - 1));
+    }
 
-            order->apply(ts_chrono, *day_data, *asset_map);
+    DLOG(INFO) << "Finished running strategy runner over a stream";
+    return result;
+}
 
-            // add any child orders to next ts
-            orders_next_ts.insert(orders_next_ts.end(),
-                                  order->suborders_.begin(),
-                                  order->suborders_.end());
+vector<string> StrategyRunner::_asset_names() const {
+    vector<string> names;
+    for (auto& a : this->assets_) names.push_back(a->name_);
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
 
-            result.orders_processed_.push_back(order);
-        }
+tuple<shared_ptr<AssetMap>, shared_ptr<BookMap>> StrategyRunner::_prepare(
+    StrategyRunnerResult& result,
+    const shared_ptr<arrow::Schema>& schema) const {
+    // copy books and stategies (assets are immutable but copy anyway)
+    for (auto& s : this->strategies_) {
+        result.strategies_.push_back(shared_ptr<Strategy>(s->clone()));
+    }
 
-        // extend with orders for next ts
-        result.orders_unprocessed_->insert(result.orders_unprocessed_->end(),
-                                           orders_next_ts.begin(),
-                                           orders_next_ts.end());
+    for (auto& b : this->books_)
+        result.books_.push_back(shared_ptr<Book>(b->clone()));
 
-        // close
-        for (auto& strategy : result.strategies_) {
-            strategy->on_close();
-        }
+    for (auto& a : this->assets_)
+        result.assets_.push_back(shared_ptr<Asset>(a->clone()));
 
-        // run book end-of-day tasks
-        for (auto& book : result.books_) {
-            book->eod_tasks(ts_chrono, *day_data, *asset_map);
-        }
+    // resolve asset columns once so the event loop reads them by index
+    ColumnPlan plan(schema);
+    for (auto& a : result.assets_) a->columns_ = a->_resolve_columns(plan);
+
+    // generate asset and book maps, asset ids follow name order so books
+    // value their positions in the same order as lockstep runs
+    shared_ptr<AssetMap> asset_map =
+        make_shared<AssetMap>(make_shared<SymbolTable>(this->_asset_names()));
+    shared_ptr<BookMap> book_map = make_shared<BookMap>();
+    for (auto a : result.assets_) asset_map->add(a);
+    for (auto b : result.books_) {
+        b->_bind_symbols(asset_map->symbols_);
+        book_map->emplace(b->name_, b);
     }
 
-    DLOG(INFO) << "Finished running strategy runner";
-    return result;
+    return {asset_map, book_map};
 }
 
 vector<StrategyRunnerResult> StrategyRunner::run_batch(
-
     const vector<ParamMap>& params_vector,
     const optional<unsigned int> num_threads) {
-    unsigned int tp_num_threads = 1;
-    if (num_threads.has_value()) {
-        tp_num_threads = num_threads.value();
-    } else {
-        tp_num_threads = params_vector.size();
-    }
-
 #ifdef EXPER_PY_SUB_INTERP
     Interpreter interp;
-    // vector<SubInterpreter> subinterps(tp_num_threads);
     pybind11::gil_scoped_acquire gil;
     SubInterpreter foo;
     ThreadsAllowedScope t1;
 #endif
 
-    BS::thread_pool pool{tp_num_threads};
+    // share derived columns across the batch
+    auto indicators = this->indicator_cache_ ? this->indicator_cache_
+                                             : make_shared<IndicatorCache>();
+
+    vector<StrategyRunnerResult> results(params_vector.size());
+    this->_executor().parallel_for(
+        0, params_vector.size(),
+        [this, &params_vector, &indicators, &results](int64_t i) {
+            results[i] = this->_run(params_vector[i], indicators);
+        },
+        num_threads.value_or(0));
+    return results;
+}
+
+shared_ptr<Table> StrategyRunner::run_batch_summary(
+    const vector<ParamMap>& params_vector, const MetricVector& metrics,
+    const optional<unsigned int> num_threads) {
+    auto& executor = this->_executor();
+    auto indicators = this->indicator_cache_ ? this->indicator_cache_
+                                             : make_shared<IndicatorCache>();
+
+    // a run's arena blocks go back to its worker's pool when the run is
+    // released, and the next run on that worker takes them from there
+    WorkerLocal<std::pmr::unsynchronized_pool_resource> pools(
+        executor, std::pmr::pool_options{0, 4 << 20});
+
+    vector<vector<double>> values(params_vector.size());
+    executor.parallel_for(
+        0, params_vector.size(),
+        [&](int64_t i) {
+            auto result =
+                this->_run(params_vector[i], indicators, &pools.local());
+            for (auto& [_, metric] : metrics)
+                values[i].push_back(metric(result));
+        },
+        num_threads.value_or(0));
+
+    vector<string> metric_names;
+    for (auto& [name, _] : metrics) metric_names.push_back(name);
+    return SummaryTable(params_vector, metric_names, values);
+}
 
-    // #ifdef EXPER_PY_SUB_INTERP
-    //     Interpreter interp;
-    //     ThreadsAllowedScope t1;
-    //     vector<SubInterpreter> subinterps(tp_num_threads);
-    // #endif
+HalvingResult StrategyRunner::run_halving(
+    const vector<ParamMap>& params_vector, const Metric& objective,
+    const HalvingOptions& options) {
+    CHECK(options.eta > 1.) << "Error: eta must be greater than 1";
+    CHECK(options.min_fraction > 0.) << "Error: min_fraction must be positive";
+
+    auto& executor = this->_executor();
+    auto indicators = this->indicator_cache_ ? this->indicator_cache_
+                                             : make_shared<IndicatorCache>();
+    auto day_table = this->_day_table();
+    auto num_rows = day_table->num_rows();
+    auto n = std::ssize(params_vector);
+
+    HalvingResult halving;
+    halving.params_ = params_vector;
+    halving.values_.assign(n, std::nan(""));
+    halving.rows_.assign(n, 0);
+
+    // a run can move to another worker between rungs, so its arena takes
+    // blocks from the heap rather than a worker's pool
+    vector<std::optional<RunState>> states(n);
+    vector<int64_t> alive(n);
+    std::iota(alive.begin(), alive.end(), 0);
+
+    auto fraction = options.min_fraction;
+    while (!alive.empty()) {
+        // within rounding of the whole data is the whole data
+        auto last = fraction >= 1. - 1e-9;
+        auto end_row = last ? num_rows
+                            : static_cast<int64_t>(std::ceil(fraction *
+                                                             num_rows));
+        executor.parallel_for(
+            0, alive.size(),
+            [&](int64_t k) {
+                auto i = alive[k];
+                if (!states[i])
+                    states[i] = this->_start(params_vector[i], indicators);
+                this->_advance(*states[i], *day_table, end_row);
+                halving.values_[i] = objective(states[i]->result_);
+                halving.rows_[i] = states[i]->next_row_;
+            },
+            options.max_parallelism);
+
+        // best first, NaN last
+        std::stable_sort(alive.begin(), alive.end(), [&](auto a, auto b) {
+            auto va = halving.values_[a], vb = halving.values_[b];
+            if (std::isnan(vb)) return !std::isnan(va);
+            if (std::isnan(va)) return false;
+            return options.maximize ? va > vb : va < vb;
+        });
+        if (last) break;
+
+        auto keep = std::max<int64_t>(
+            1, static_cast<int64_t>(std::ceil(alive.size() / options.eta)));
+        for (auto k = keep; k < std::ssize(alive); ++k)
+            states[alive[k]].reset();
+        alive.resize(std::min<int64_t>(keep, alive.size()));
+        fraction *= options.eta;
+    }
 
-    BS::multi_future<StrategyRunnerResult> sequence_future =
-        pool.submit_sequence<int>(0, params_vector.size(),
-                                  [this, &params_vector](int i) {
-                                      return this->run(params_vector[i]);
-                                  });
-    std::vector<StrategyRunnerResult> results = sequence_future.get();
-    return results;
+    for (auto i : alive) {
+        halving.finalists_.push_back(i);
+        halving.results_.push_back(std::move(states[i]->result_));
+    }
+    return halving;
+}
+
+SearchResult StrategyRunner::run_search(const ParamSpace& space,
+                                        const Metric& objective,
+                                        const SearchOptions& options) {
+    auto& executor = this->_executor();
+    auto indicators = this->indicator_cache_ ? this->indicator_cache_
+                                             : make_shared<IndicatorCache>();
+    WorkerLocal<std::pmr::unsynchronized_pool_resource> pools(
+        executor, std::pmr::pool_options{0, 4 << 20});
+
+    // trials are handed out in order as workers free up, so a trial is
+    // asked for once the ones before it have started
+    ParamSearch search(space, options);
+    executor.parallel_for(
+        0, options.num_trials,
+        [&](int64_t i) {
+            auto result =
+                this->_run(search.ask(i), indicators, &pools.local());
+            search.tell(i, objective(result));
+        },
+        options.max_parallelism);
+    return search.result();
 }
 
 }  // namespace YABTE::BackTest
\ No newline at end of file
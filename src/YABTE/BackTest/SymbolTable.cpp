@@ -0,0 +1,31 @@
+#include "YABTE/BackTest/SymbolTable.hpp"
+
+#include <stdexcept>
+
+namespace YABTE::BackTest {
+
+SymbolTable::SymbolTable(const vector<string> &names) {
+    for (auto &name : names) this->intern(name);
+}
+
+AssetId SymbolTable::intern(const string &name) {
+    auto [it, inserted] =
+        this->ids_.emplace(name, static_cast<AssetId>(this->names_.size()));
+    if (inserted) this->names_.push_back(name);
+    return it->second;
+}
+
+AssetId SymbolTable::find(const string &name) const {
+    auto it = this->ids_.find(name);
+    return it == this->ids_.end() ? NO_ASSET_ID : it->second;
+}
+
+AssetId SymbolTable::id(const string &name) const {
+    auto id = this->find(name);
+    if (id == NO_ASSET_ID) {
+        throw std::out_of_range("Asset not found: " + name);
+    }
+    return id;
+}
+
+}  // namespace YABTE::BackTest
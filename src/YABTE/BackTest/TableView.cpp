@@ -0,0 +1,135 @@
+#include "YABTE/BackTest/TableView.hpp"
+
+#include <arrow/array.h>
+#include <arrow/array/concatenate.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace YABTE::BackTest {
+
+double ColumnView::as_double(const int64_t row) const {
+    if (!this->is_valid(row)) return std::nan("");
+
+    switch (this->type) {
+        case arrow::Type::DOUBLE:
+            return this->value<double>(row);
+        case arrow::Type::FLOAT:
+            return this->value<float>(row);
+        case arrow::Type::INT64:
+            return static_cast<double>(this->value<int64_t>(row));
+        case arrow::Type::INT32:
+            return this->value<int32_t>(row);
+        case arrow::Type::BOOL:
+            return arrow::bit_util::GetBit(this->values, this->offset + row);
+        default:
+            throw std::runtime_error("Unsupported column type");
+    }
+}
+
+TableView::TableView(const shared_ptr<const arrow::Table> &table) {
+    // the views only read, so single chunk columns (e.g. the runner's
+    // combined data under a strategy's extended columns, or a table mapped
+    // from shared memory) are used in place and only the others are
+    // combined
+    auto columns = table->columns();
+    auto combined = false;
+    for (auto &col : columns) {
+        if (col->num_chunks() <= 1) continue;
+        auto st_c = arrow::Concatenate(col->chunks());
+        if (!st_c.ok()) {
+            throw std::runtime_error("Error: " + st_c.status().ToString());
+        }
+        col = std::make_shared<arrow::ChunkedArray>(st_c.ValueOrDie());
+        combined = true;
+    }
+    this->table_ = combined ? arrow::Table::Make(table->schema(), columns,
+                                                 table->num_rows())
+                            : std::const_pointer_cast<arrow::Table>(table);
+    this->num_rows_ = this->table_->num_rows();
+
+    for (auto &col : this->table_->columns()) {
+        ColumnView cv;
+        cv.type = col->type()->id();
+        if (col->num_chunks() > 0) {
+            auto &data = col->chunk(0)->data();
+            cv.offset = data->offset;
+            cv.length = data->length;
+            if (data->buffers.size() > 0 && data->buffers[0] &&
+                data->null_count != 0)
+                cv.validity = data->buffers[0]->data();
+            if (data->buffers.size() > 1 && data->buffers[1])
+                cv.values = data->buffers[1]->data();
+        }
+        this->columns_.push_back(cv);
+    }
+}
+
+int TableView::column_index(const string &name) const {
+    return this->table_->schema()->GetFieldIndex(name);
+}
+
+shared_ptr<arrow::Table> DayView::to_table() const {
+    return this->table_->table_->Slice(this->row_, 1);
+}
+
+DataWindow::DataWindow(const shared_ptr<const arrow::Table> &table,
+                       const int64_t size)
+    : view_(table) {
+    this->advance_to(size);
+}
+
+void DataWindow::advance_to(const int64_t size) {
+    if (size < this->base_ || size > this->base_ + this->view_.num_rows()) {
+        throw std::out_of_range("Window size out of range");
+    }
+    this->size_ = size;
+}
+
+void DataWindow::rebase(const shared_ptr<const arrow::Table> &table,
+                        const int64_t base) {
+    TableView view(table);
+    if (this->size_ < base || this->size_ > base + view.num_rows()) {
+        throw std::out_of_range("Window size out of range");
+    }
+    this->view_ = std::move(view);
+    this->base_ = base;
+}
+
+int DataWindow::column_index(const string &name) const {
+    return this->view_.column_index(name);
+}
+
+WindowColumn DataWindow::column(const string &name) const {
+    auto index = this->column_index(name);
+    if (index < 0) {
+        throw std::out_of_range("Column not found: " + name);
+    }
+    return WindowColumn(*this, index);
+}
+
+WindowColumn DataWindow::column(const int index) const {
+    if (index < 0 || index >= this->view_.num_columns()) {
+        throw std::out_of_range("Column index out of range");
+    }
+    return WindowColumn(*this, index);
+}
+
+int64_t DataWindow::_row(const int64_t offset) const {
+    auto row = offset < 0 ? this->size_ + offset : offset;
+    if (row < this->base_ || row >= this->size_) {
+        throw std::out_of_range("Row outside of data window");
+    }
+    return row - this->base_;
+}
+
+shared_ptr<arrow::Table> DataWindow::table() const {
+    return this->view_.table_->Slice(0, this->size_ - this->base_);
+}
+
+shared_ptr<arrow::ChunkedArray> DataWindow::array(const string &name) const {
+    return this->view_.table_->column(this->column(name).index_)->Slice(
+        0, this->size_ - this->base_);
+}
+
+}  // namespace YABTE::BackTest
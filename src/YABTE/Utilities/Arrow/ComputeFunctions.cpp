@@ -0,0 +1,207 @@
+#include "YABTE/Utilities/Arrow/ComputeFunctions.hpp"
+
+#include <arrow/compute/api.h>
+
+#include <memory>
+#include <type_traits>
+
+#include "YABTE/Utilities/Arrow/Rolling.hpp"
+
+using std::shared_ptr, std::make_shared;
+
+using arrow::Datum, arrow::Result, arrow::ChunkedArray,
+    arrow::compute::InputType, arrow::compute::KernelSignature,
+    arrow::compute::VectorFunction, arrow::compute::VectorKernel,
+    arrow::compute::FunctionDoc, arrow::compute::Arity,
+    arrow::compute::KernelContext, arrow::compute::ExecSpan,
+    arrow::compute::ExecResult, arrow::compute::ExecBatch;
+
+namespace YABTE::Utilities::Arrow {
+
+namespace {
+
+// the value types the rolling kernels accept
+const vector<shared_ptr<arrow::DataType>> &value_types() {
+    static const vector<shared_ptr<arrow::DataType>> types{
+        arrow::float64(), arrow::float32(), arrow::int64(), arrow::int32()};
+    return types;
+}
+
+Result<shared_ptr<ChunkedArray>> ToChunked(const Datum &d) {
+    if (d.is_chunked_array()) return d.chunked_array();
+    if (d.is_array()) return make_shared<ChunkedArray>(d.make_array());
+    return Status::Invalid("Expected an array argument, got ", d.ToString());
+}
+
+// numeric scalar parameter i, or def when it was not passed
+template <typename T>
+Result<T> Param(const vector<Datum> &args, const size_t i, const T def) {
+    if (i >= args.size()) return def;
+    if (!args[i].is_scalar() || !args[i].scalar()->is_valid)
+        return Status::Invalid("Parameter ", i, " must be a valid scalar");
+
+    auto to = std::is_integral_v<T> ? arrow::int64() : arrow::float64();
+    ARROW_ASSIGN_OR_RAISE(auto s, args[i].scalar()->CastTo(to));
+    if constexpr (std::is_integral_v<T>)
+        return static_cast<T>(
+            std::static_pointer_cast<arrow::Int64Scalar>(s)->value);
+    else
+        return static_cast<T>(
+            std::static_pointer_cast<arrow::DoubleScalar>(s)->value);
+}
+
+using Impl = Result<shared_ptr<ChunkedArray>> (*)(const vector<Datum> &);
+
+template <Result<shared_ptr<ChunkedArray>> (*F)(
+    const shared_ptr<ChunkedArray> &, int64_t, int64_t)>
+Result<shared_ptr<ChunkedArray>> WindowImpl(const vector<Datum> &args) {
+    if (args.size() > 3) return Status::Invalid("Too many arguments");
+    ARROW_ASSIGN_OR_RAISE(auto vals, ToChunked(args[0]));
+    ARROW_ASSIGN_OR_RAISE(auto window, Param<int64_t>(args, 1, 0));
+    ARROW_ASSIGN_OR_RAISE(auto min_periods, Param<int64_t>(args, 2, -1));
+    return F(vals, window, min_periods);
+}
+
+template <Result<shared_ptr<ChunkedArray>> (*F)(
+    const shared_ptr<ChunkedArray> &, int64_t, int64_t, int)>
+Result<shared_ptr<ChunkedArray>> MomentImpl(const vector<Datum> &args) {
+    if (args.size() > 4) return Status::Invalid("Too many arguments");
+    ARROW_ASSIGN_OR_RAISE(auto vals, ToChunked(args[0]));
+    ARROW_ASSIGN_OR_RAISE(auto window, Param<int64_t>(args, 1, 0));
+    ARROW_ASSIGN_OR_RAISE(auto min_periods, Param<int64_t>(args, 2, -1));
+    ARROW_ASSIGN_OR_RAISE(auto ddof, Param<int>(args, 3, 1));
+    return F(vals, window, min_periods, ddof);
+}
+
+Result<shared_ptr<ChunkedArray>> EmaImpl(const vector<Datum> &args) {
+    if (args.size() > 3) return Status::Invalid("Too many arguments");
+    ARROW_ASSIGN_OR_RAISE(auto vals, ToChunked(args[0]));
+    ARROW_ASSIGN_OR_RAISE(auto span, Param<double>(args, 1, 0.));
+    ARROW_ASSIGN_OR_RAISE(auto min_periods, Param<int64_t>(args, 2, 1));
+    return ExponentialMovingAverage(vals, span, min_periods);
+}
+
+Result<shared_ptr<ChunkedArray>> CrossoverImpl(const vector<Datum> &args) {
+    ARROW_ASSIGN_OR_RAISE(auto a, ToChunked(args[0]));
+    ARROW_ASSIGN_OR_RAISE(auto b, ToChunked(args[1]));
+    return Crossover(a, b);
+}
+
+// kernels need the whole column, so array inputs go through exec and
+// chunked inputs through exec_chunked
+template <Impl F>
+Status ExecArray(KernelContext *, const ExecSpan &span, ExecResult *out) {
+    vector<Datum> args;
+    for (auto const &v : span.values) {
+        if (v.is_array())
+            args.emplace_back(v.array.ToArrayData());
+        else
+            args.emplace_back(v.scalar->GetSharedPtr());
+    }
+    ARROW_ASSIGN_OR_RAISE(auto result, F(args));
+    // results are always a single chunk
+    out->value = result->chunk(0)->data();
+    return Status::OK();
+}
+
+template <Impl F>
+Status ExecChunked(KernelContext *, const ExecBatch &batch, Datum *out) {
+    ARROW_ASSIGN_OR_RAISE(auto result, F(batch.values));
+    *out = result;
+    return Status::OK();
+}
+
+template <Impl F>
+VectorKernel MakeKernel(vector<InputType> in_types,
+                        const shared_ptr<arrow::DataType> &out_type,
+                        const bool is_varargs) {
+    VectorKernel kernel(
+        KernelSignature::Make(std::move(in_types), out_type, is_varargs),
+        ExecArray<F>);
+    kernel.exec_chunked = ExecChunked<F>;
+    kernel.can_execute_chunkwise = false;
+    kernel.output_chunked = false;
+    return kernel;
+}
+
+// values plus trailing scalar parameters
+template <Impl F>
+Status AddWindowFunction(arrow::compute::FunctionRegistry *registry,
+                         const string &name, const string &summary,
+                         const vector<string> &arg_names) {
+    auto func = make_shared<VectorFunction>(
+        name, Arity::VarArgs(2), FunctionDoc(summary, "", arg_names));
+    for (auto const &type : value_types()) {
+        ARROW_RETURN_NOT_OK(func->AddKernel(MakeKernel<F>(
+            {InputType(type), InputType::Any()}, arrow::float64(), true)));
+    }
+    return registry->AddFunction(std::move(func));
+}
+
+Status AddCrossoverFunction(arrow::compute::FunctionRegistry *registry) {
+    auto func = make_shared<VectorFunction>(
+        "yabte_crossover", Arity::Binary(),
+        FunctionDoc("True where a crosses above b", "", {"a", "b"}));
+    for (auto const &a : value_types()) {
+        for (auto const &b : value_types()) {
+            ARROW_RETURN_NOT_OK(func->AddKernel(MakeKernel<CrossoverImpl>(
+                {InputType(a), InputType(b)}, arrow::boolean(), false)));
+        }
+    }
+    return registry->AddFunction(std::move(func));
+}
+
+}  // namespace
+
+const vector<string> &ComputeFunctionNames() {
+    static const vector<string> names{
+        "yabte_rolling_sum", "yabte_rolling_mean",   "yabte_rolling_min",
+        "yabte_rolling_max", "yabte_rolling_rank",   "yabte_rolling_var",
+        "yabte_rolling_std", "yabte_rolling_zscore", "yabte_ema",
+        "yabte_crossover"};
+    return names;
+}
+
+Status RegisterComputeFunctions(arrow::compute::FunctionRegistry *registry) {
+    if (registry == nullptr)
+        registry = arrow::compute::GetFunctionRegistry();
+
+    // already registered
+    if (registry->GetFunction(ComputeFunctionNames().front()).ok())
+        return Status::OK();
+
+    const vector<string> window_args{"values", "window", "min_periods"};
+    const vector<string> moment_args{"values", "window", "min_periods",
+                                     "ddof"};
+
+    ARROW_RETURN_NOT_OK(AddWindowFunction<WindowImpl<RollingSum>>(
+        registry, "yabte_rolling_sum", "Rolling window sum", window_args));
+    ARROW_RETURN_NOT_OK(AddWindowFunction<WindowImpl<RollingMean>>(
+        registry, "yabte_rolling_mean", "Rolling window mean", window_args));
+    ARROW_RETURN_NOT_OK(AddWindowFunction<WindowImpl<RollingMin>>(
+        registry, "yabte_rolling_min", "Rolling window minimum",
+        window_args));
+    ARROW_RETURN_NOT_OK(AddWindowFunction<WindowImpl<RollingMax>>(
+        registry, "yabte_rolling_max", "Rolling window maximum",
+        window_args));
+    ARROW_RETURN_NOT_OK(AddWindowFunction<WindowImpl<RollingRank>>(
+        registry, "yabte_rolling_rank", "Rank of each value in its window",
+        window_args));
+    ARROW_RETURN_NOT_OK(AddWindowFunction<MomentImpl<RollingVar>>(
+        registry, "yabte_rolling_var", "Rolling window variance",
+        moment_args));
+    ARROW_RETURN_NOT_OK(AddWindowFunction<MomentImpl<RollingStd>>(
+        registry, "yabte_rolling_std", "Rolling window standard deviation",
+        moment_args));
+    ARROW_RETURN_NOT_OK(AddWindowFunction<MomentImpl<RollingZScore>>(
+        registry, "yabte_rolling_zscore", "Rolling window z-score",
+        moment_args));
+    ARROW_RETURN_NOT_OK(AddWindowFunction<EmaImpl>(
+        registry, "yabte_ema", "Exponential moving average",
+        {"values", "span", "min_periods"}));
+    ARROW_RETURN_NOT_OK(AddCrossoverFunction(registry));
+
+    return Status::OK();
+}
+
+}  // namespace YABTE::Utilities::Arrow
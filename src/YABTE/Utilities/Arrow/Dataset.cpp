@@ -0,0 +1,269 @@
+#include "YABTE/Utilities/Arrow/Dataset.hpp"
+
+#include <arrow/compute/api.h>
+#include <arrow/dataset/api.h>
+#include <arrow/filesystem/api.h>
+#include <arrow/util/thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <numeric>
+
+using std::map, std::make_shared, std::chrono::duration_cast,
+    std::chrono::nanoseconds;
+
+using arrow::Status;
+
+namespace ds = arrow::dataset;
+namespace cp = arrow::compute;
+
+namespace YABTE::Utilities::Arrow {
+
+namespace {
+
+cp::Expression asset_filter(const DatasetOptions &options,
+                            const vector<string> &assets) {
+    vector<cp::Expression> matches;
+    for (auto &asset : assets) {
+        matches.push_back(cp::equal(cp::field_ref(options.asset_partition),
+                                    cp::literal(asset)));
+    }
+    return matches.empty() ? cp::literal(true) : cp::or_(matches);
+}
+
+// bounds are typed as date_type, so they compare with zoned dates too
+cp::Expression date_filter(const DatasetOptions &options,
+                           const shared_ptr<arrow::DataType> &date_type) {
+    auto bound = [&](const time_point<system_clock> &tp) {
+        auto ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+        return cp::literal(
+            std::make_shared<arrow::TimestampScalar>(ns, date_type));
+    };
+    vector<cp::Expression> bounds{cp::literal(true)};
+    if (options.start) {
+        bounds.push_back(cp::greater_equal(cp::field_ref(options.date_column),
+                                           bound(*options.start)));
+    }
+    if (options.end) {
+        bounds.push_back(
+            cp::less(cp::field_ref(options.date_column), bound(*options.end)));
+    }
+    return cp::and_(bounds);
+}
+
+// dates of a column as nanoseconds
+Result<vector<int64_t>> date_values(
+    const shared_ptr<arrow::ChunkedArray> &date) {
+    // utc values, whatever the column's time zone
+    auto type = date->type();
+    auto zone =
+        type->id() == arrow::Type::TIMESTAMP
+            ? std::static_pointer_cast<arrow::TimestampType>(type)->timezone()
+            : "";
+    ARROW_ASSIGN_OR_RAISE(
+        auto ts, cp::Cast(date, arrow::timestamp(arrow::TimeUnit::NANO, zone)));
+    ARROW_ASSIGN_OR_RAISE(auto ints, cp::Cast(ts, arrow::int64()));
+    auto values = ints.chunked_array();
+    if (values->null_count() != 0) {
+        return Status::Invalid("Null dates in dataset");
+    }
+    vector<int64_t> out;
+    out.reserve(values->length());
+    for (auto &chunk : values->chunks()) {
+        auto raw = static_cast<const arrow::Int64Array &>(*chunk).raw_values();
+        out.insert(out.end(), raw, raw + chunk->length());
+    }
+    return out;
+}
+
+// scan columns of the rows matching filter on a bounded pool, files and
+// row groups the filter excludes are skipped
+Result<shared_ptr<ds::Scanner>> make_scanner(
+    const shared_ptr<ds::Dataset> &dataset, const vector<string> &columns,
+    const cp::Expression &filter, const DatasetOptions &options,
+    arrow::internal::Executor *executor) {
+    auto scan_options = make_shared<ds::ScanOptions>();
+    if (executor) scan_options->cpu_executor = executor;
+
+    ds::ScannerBuilder builder(dataset, scan_options);
+    ARROW_RETURN_NOT_OK(builder.Project(columns));
+    ARROW_RETURN_NOT_OK(builder.Filter(filter));
+    ARROW_RETURN_NOT_OK(builder.UseThreads(true));
+    ARROW_RETURN_NOT_OK(builder.FragmentReadahead(options.fragment_readahead));
+    ARROW_RETURN_NOT_OK(builder.BatchReadahead(options.batch_readahead));
+    return builder.Finish();
+}
+
+}  // namespace
+
+Result<shared_ptr<Table>> LoadDataset(const string &root,
+                                      const DatasetOptions &options) {
+    // discover files and partitions
+    string base_dir;
+    ARROW_ASSIGN_OR_RAISE(auto filesystem,
+                          arrow::fs::FileSystemFromUriOrPath(root, &base_dir));
+
+    arrow::fs::FileSelector selector;
+    selector.base_dir = base_dir;
+    selector.recursive = true;
+
+    ds::FileSystemFactoryOptions factory_options;
+    factory_options.partition_base_dir = base_dir;
+    if (options.partition_fields.empty()) {
+        factory_options.partitioning = ds::HivePartitioning::MakeFactory();
+    } else {
+        arrow::FieldVector fields;
+        for (auto &name : options.partition_fields)
+            fields.push_back(arrow::field(name, arrow::utf8()));
+        factory_options.partitioning =
+            make_shared<ds::DirectoryPartitioning>(arrow::schema(fields));
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto factory,
+                          ds::FileSystemDatasetFactory::Make(
+                              filesystem, selector,
+                              make_shared<ds::ParquetFileFormat>(),
+                              factory_options));
+    ARROW_ASSIGN_OR_RAISE(auto dataset, factory->Finish());
+
+    auto partition_schema =
+        std::static_pointer_cast<ds::FileSystemDataset>(dataset)
+            ->partitioning()
+            ->schema();
+    if (partition_schema->GetFieldIndex(options.asset_partition) < 0) {
+        return Status::KeyError("Asset partition not found: ",
+                                options.asset_partition);
+    }
+
+    // projected file columns
+    vector<string> fields;
+    for (auto &field : dataset->schema()->fields()) {
+        auto &name = field->name();
+        if (name == options.date_column ||
+            partition_schema->GetFieldIndex(name) >= 0)
+            continue;
+        if (options.fields.empty() ||
+            std::find(options.fields.begin(), options.fields.end(), name) !=
+                options.fields.end())
+            fields.push_back(name);
+    }
+    vector<string> columns{options.asset_partition, options.date_column};
+    columns.insert(columns.end(), fields.begin(), fields.end());
+
+    // the output dates keep the source's time zone
+    auto date_field = dataset->schema()->GetFieldByName(options.date_column);
+    if (!date_field) {
+        return Status::KeyError("Date column not found: ", options.date_column);
+    }
+    string zone;
+    if (date_field->type()->id() == arrow::Type::TIMESTAMP) {
+        zone = std::static_pointer_cast<arrow::TimestampType>(
+                   date_field->type())
+                   ->timezone();
+    }
+    auto date_type = arrow::timestamp(arrow::TimeUnit::NANO, zone);
+
+    shared_ptr<arrow::internal::ThreadPool> pool;
+    if (options.num_threads > 0) {
+        ARROW_ASSIGN_OR_RAISE(
+            pool, arrow::internal::ThreadPool::Make(options.num_threads));
+    }
+    auto in_range = date_filter(options, date_type);
+
+    // first pass over only the asset and date columns for each asset's
+    // dates, a batch comes from a single file so holds a single asset
+    map<string, vector<int64_t>> asset_dates;
+    {
+        vector<string> keys{options.asset_partition, options.date_column};
+        ARROW_ASSIGN_OR_RAISE(
+            auto scanner,
+            make_scanner(
+                dataset, keys,
+                cp::and_(asset_filter(options, options.assets), in_range),
+                options, pool.get()));
+        ARROW_ASSIGN_OR_RAISE(auto batches, scanner->ScanBatches());
+        while (true) {
+            ARROW_ASSIGN_OR_RAISE(auto tagged, batches.Next());
+            if (arrow::IsIterationEnd(tagged)) break;
+            auto &batch = tagged.record_batch;
+            if (batch->num_rows() == 0) continue;
+            ARROW_ASSIGN_OR_RAISE(
+                auto asset,
+                batch->GetColumnByName(options.asset_partition)->GetScalar(0));
+            ARROW_ASSIGN_OR_RAISE(
+                auto dates,
+                date_values(make_shared<arrow::ChunkedArray>(
+                    batch->GetColumnByName(options.date_column))));
+            auto &all = asset_dates[asset->ToString()];
+            all.insert(all.end(), dates.begin(), dates.end());
+        }
+    }
+
+    // union calendar of each asset's dates, sorted
+    vector<int64_t> calendar;
+    for (auto &[asset, dates] : asset_dates)
+        calendar.insert(calendar.end(), dates.begin(), dates.end());
+    std::sort(calendar.begin(), calendar.end());
+    calendar.erase(std::unique(calendar.begin(), calendar.end()),
+                   calendar.end());
+
+    arrow::TimestampBuilder date_builder(date_type,
+                                         arrow::default_memory_pool());
+    ARROW_RETURN_NOT_OK(date_builder.AppendValues(calendar));
+    ARROW_ASSIGN_OR_RAISE(auto date_array, date_builder.Finish());
+
+    arrow::FieldVector out_fields{
+        arrow::field(options.date_column, date_array->type())};
+    arrow::ChunkedArrayVector out_columns{
+        make_shared<arrow::ChunkedArray>(date_array)};
+
+    // second pass an asset at a time, each aligned on the calendar with a
+    // take and released before the next is scanned, so at most one
+    // asset's rows are held beside the output
+    for (auto &[asset, first_dates] : asset_dates) {
+        first_dates = {};
+        ARROW_ASSIGN_OR_RAISE(
+            auto scanner,
+            make_scanner(dataset, columns,
+                         cp::and_(asset_filter(options, {asset}), in_range),
+                         options, pool.get()));
+        ARROW_ASSIGN_OR_RAISE(auto table, scanner->ToTable());
+        ARROW_ASSIGN_OR_RAISE(
+            auto dates,
+            date_values(table->GetColumnByName(options.date_column)));
+
+        vector<int64_t> order(dates.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&](auto a, auto b) { return dates[a] < dates[b]; });
+
+        arrow::Int64Builder indices;
+        ARROW_RETURN_NOT_OK(indices.Reserve(calendar.size()));
+        size_t k = 0;
+        for (auto day : calendar) {
+            if (k < order.size() && dates[order[k]] == day) {
+                if (k + 1 < order.size() && dates[order[k + 1]] == day) {
+                    return Status::Invalid("Duplicate date for asset ", asset);
+                }
+                indices.UnsafeAppend(order[k++]);
+            } else {
+                indices.UnsafeAppendNull();
+            }
+        }
+        ARROW_ASSIGN_OR_RAISE(auto take, indices.Finish());
+
+        for (auto &field : fields) {
+            auto column = table->GetColumnByName(field);
+            ARROW_ASSIGN_OR_RAISE(auto aligned, cp::Take(column, take));
+            out_fields.push_back(arrow::field(
+                "('" + asset + "', '" + field + "')", column->type()));
+            out_columns.push_back(aligned.chunked_array());
+        }
+    }
+
+    return Table::Make(arrow::schema(out_fields), out_columns,
+                       static_cast<int64_t>(calendar.size()));
+}
+
+}  // namespace YABTE::Utilities::Arrow
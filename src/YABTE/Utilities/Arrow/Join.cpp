@@ -0,0 +1,144 @@
+#include "YABTE/Utilities/Arrow/Join.hpp"
+
+#include <arrow/array/concatenate.h>
+#include <arrow/compute/api.h>
+
+#include <vector>
+
+using std::vector;
+
+using arrow::Status;
+
+namespace cp = arrow::compute;
+
+namespace YABTE::Utilities::Arrow {
+
+namespace {
+
+// the date column as contiguous nanoseconds, zero copy when it is already
+// a single timestamp[ns] chunk
+Result<shared_ptr<arrow::Int64Array>> date_values(
+    const shared_ptr<const Table> &table, const string &on) {
+    auto date = table->GetColumnByName(on);
+    if (!date) return Status::KeyError("Date column not found: ", on);
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto ts, cp::Cast(date, arrow::timestamp(arrow::TimeUnit::NANO)));
+    ARROW_ASSIGN_OR_RAISE(auto ints, cp::Cast(ts, arrow::int64()));
+    auto values = ints.chunked_array();
+    if (values->null_count() != 0) {
+        return Status::Invalid("Null dates in column ", on);
+    }
+
+    shared_ptr<arrow::Array> array;
+    if (values->num_chunks() == 1) {
+        array = values->chunk(0);
+    } else if (values->num_chunks() == 0) {
+        ARROW_ASSIGN_OR_RAISE(array, arrow::MakeEmptyArray(arrow::int64()));
+    } else {
+        ARROW_ASSIGN_OR_RAISE(array, arrow::Concatenate(values->chunks()));
+    }
+    auto out = std::static_pointer_cast<arrow::Int64Array>(array);
+
+    auto raw = out->raw_values();
+    for (int64_t i = 1; i < out->length(); ++i) {
+        if (raw[i] < raw[i - 1]) {
+            return Status::Invalid("Dates not sorted in column ", on);
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+Result<shared_ptr<Table>> AsOfAlign(const shared_ptr<const Table> &left,
+                                    const shared_ptr<const Table> &right,
+                                    const AsOfJoinOptions &options) {
+    ARROW_ASSIGN_OR_RAISE(auto left_dates, date_values(left, options.on));
+    ARROW_ASSIGN_OR_RAISE(auto right_dates, date_values(right, options.on));
+    auto l = left_dates->raw_values();
+    auto r = right_dates->raw_values();
+    auto n = left_dates->length(), m = right_dates->length();
+
+    auto backward = options.direction == AsOfDirection::BACKWARD;
+    auto exact = options.allow_exact_matches;
+    auto tolerance = options.tolerance ? options.tolerance->count() : -1;
+    if (options.tolerance && tolerance < 0) {
+        return Status::Invalid("Negative as-of tolerance");
+    }
+
+    // matched right row for each left row, -1 for none. both sides are
+    // sorted so the right cursor only moves forward.
+    vector<int64_t> match(n);
+    int64_t j = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        int64_t k;
+        if (backward) {
+            while (j < m && (r[j] < l[i] || (exact && r[j] == l[i]))) ++j;
+            k = j - 1;
+        } else {
+            while (j < m && (r[j] < l[i] || (!exact && r[j] == l[i]))) ++j;
+            k = j < m ? j : -1;
+        }
+        if (k >= 0 && tolerance >= 0 &&
+            (backward ? l[i] - r[k] : r[k] - l[i]) > tolerance)
+            k = -1;
+        match[i] = k;
+    }
+
+    // every row matched and consecutive, i.e. a slice of right
+    auto first = n > 0 ? match[0] : 0;
+    auto contiguous = true;
+    for (int64_t i = 0; i < n && contiguous; ++i) {
+        contiguous = match[i] >= 0 && match[i] == first + i;
+    }
+
+    shared_ptr<arrow::Array> take;
+    if (!contiguous) {
+        arrow::Int64Builder indices;
+        ARROW_RETURN_NOT_OK(indices.Reserve(n));
+        for (auto k : match) {
+            if (k >= 0)
+                indices.UnsafeAppend(k);
+            else
+                indices.UnsafeAppendNull();
+        }
+        ARROW_ASSIGN_OR_RAISE(take, indices.Finish());
+    }
+
+    arrow::FieldVector fields;
+    arrow::ChunkedArrayVector columns;
+    for (int c = 0; c < right->num_columns(); ++c) {
+        auto &field = right->schema()->field(c);
+        if (field->name() == options.on) continue;
+
+        auto &column = right->column(c);
+        fields.push_back(field);
+        if (contiguous) {
+            columns.push_back(n == m ? column : column->Slice(first, n));
+        } else {
+            ARROW_ASSIGN_OR_RAISE(auto aligned, cp::Take(column, take));
+            columns.push_back(aligned.chunked_array());
+        }
+    }
+
+    return Table::Make(arrow::schema(fields, right->schema()->metadata()),
+                       columns, n);
+}
+
+Result<shared_ptr<Table>> AsOfJoin(const shared_ptr<const Table> &left,
+                                   const shared_ptr<const Table> &right,
+                                   const AsOfJoinOptions &options) {
+    ARROW_ASSIGN_OR_RAISE(auto aligned, AsOfAlign(left, right, options));
+
+    auto fields = left->schema()->fields();
+    auto columns = left->columns();
+    for (int c = 0; c < aligned->num_columns(); ++c) {
+        fields.push_back(aligned->schema()->field(c));
+        columns.push_back(aligned->column(c));
+    }
+    return Table::Make(arrow::schema(fields, left->schema()->metadata()),
+                       columns, left->num_rows());
+}
+
+}  // namespace YABTE::Utilities::Arrow
@@ -0,0 +1,433 @@
+#include "YABTE/Utilities/Arrow/Loaders.hpp"
+
+#include <arrow/adapters/orc/adapter.h>
+#include <arrow/compute/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+#include <arrow/ipc/feather.h>
+#include <glog/logging.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/statistics.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "YABTE/Utilities/Arrow/TableHelpers.hpp"
+
+using std::chrono::duration_cast, std::chrono::nanoseconds;
+
+using arrow::Status, arrow::Datum;
+
+namespace fs = std::filesystem;
+
+namespace YABTE::Utilities::Arrow {
+
+namespace {
+
+bool contains(const vector<string> &xs, const string &x) {
+    return std::find(xs.begin(), xs.end(), x) != xs.end();
+}
+
+bool keep_column(const string &name, const LoadOptions &options) {
+    if (!options.selects_columns() || name == options.date_column ||
+        contains(options.columns, name))
+        return true;
+    if (options.assets.empty() && options.fields.empty()) return false;
+
+    auto parsed = ParseColumnName(name);
+    if (!parsed) return false;
+    auto &[asset, field] = *parsed;
+    return (options.assets.empty() || contains(options.assets, asset)) &&
+           (options.fields.empty() || contains(options.fields, field));
+}
+
+int64_t to_ns(const time_point<system_clock> &tp) {
+    return duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+}
+
+int64_t ns_per_unit(const arrow::TimeUnit::type unit) {
+    switch (unit) {
+        case arrow::TimeUnit::SECOND:
+            return 1000000000;
+        case arrow::TimeUnit::MILLI:
+            return 1000000;
+        case arrow::TimeUnit::MICRO:
+            return 1000;
+        default:
+            return 1;
+    }
+}
+
+// false if the row group's date statistics show no row can be in range
+bool row_group_in_range(const parquet::FileMetaData &metadata, const int rg,
+                        const int date_leaf,
+                        const arrow::TimestampType &date_type,
+                        const LoadOptions &options) {
+    auto stats = metadata.RowGroup(rg)->ColumnChunk(date_leaf)->statistics();
+    if (!stats || !stats->HasMinMax() ||
+        stats->physical_type() != parquet::Type::INT64)
+        return true;
+
+    auto &typed = static_cast<const parquet::Int64Statistics &>(*stats);
+    auto per = ns_per_unit(date_type.unit());
+    if (options.start && typed.max() * per < to_ns(*options.start))
+        return false;
+    if (options.end && typed.min() * per >= to_ns(*options.end)) return false;
+    return true;
+}
+
+Result<shared_ptr<arrow::io::RandomAccessFile>> open_input(
+    const string &path, const LoadOptions &options) {
+    if (options.memory_map) {
+        return arrow::io::MemoryMappedFile::Open(path,
+                                                 arrow::io::FileMode::READ);
+    }
+    return arrow::io::ReadableFile::Open(path);
+}
+
+FileFormat resolve_format(const string &path, const LoadOptions &options) {
+    if (options.format != FileFormat::AUTO) return options.format;
+    auto ext = fs::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    if (ext == ".orc") return FileFormat::ORC;
+    if (ext == ".arrow" || ext == ".feather" || ext == ".ipc")
+        return FileFormat::IPC;
+    return FileFormat::PARQUET;
+}
+
+// 64 bit fnv-1a, stable across builds unlike std::hash
+uint64_t fnv1a(const string &s) {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// cache file for the source file (as it is now) and the options that
+// change what is loaded, named <stem>-<source>-<version>-<options>.arrow by
+// hashes of the source's path, its size and mtime, and the options
+struct CacheFile {
+    fs::path path;
+    // prefixes of every cache file of the source, and of this version
+    string source_prefix;
+    string version_prefix;
+};
+
+Result<CacheFile> cache_file(const string &path, const FileFormat format,
+                             const LoadOptions &options) {
+    std::error_code ec;
+    auto source = fs::canonical(path, ec);
+    if (ec) return Status::IOError("Cannot resolve ", path, ": ", ec.message());
+    auto size = fs::file_size(source, ec);
+    if (ec) return Status::IOError("Cannot stat ", path, ": ", ec.message());
+    auto mtime = fs::last_write_time(source, ec);
+    if (ec) return Status::IOError("Cannot stat ", path, ": ", ec.message());
+
+    auto sep = '\x1f';
+    std::ostringstream version;
+    version << size << sep << mtime.time_since_epoch().count();
+
+    std::ostringstream key;
+    key << static_cast<int>(format) << sep << options.date_column;
+    for (auto *names : {&options.assets, &options.fields, &options.columns}) {
+        key << sep;
+        for (auto &name : *names) key << name << ',';
+    }
+    key << sep << (options.start ? to_ns(*options.start) : 0) << sep
+        << (options.end ? to_ns(*options.end) : 0) << sep
+        << options.start.has_value() << options.end.has_value();
+
+    auto hex = [](const uint64_t h) {
+        std::ostringstream out;
+        out << std::hex << h;
+        return out.str();
+    };
+    CacheFile file;
+    file.source_prefix =
+        source.stem().string() + '-' + hex(fnv1a(source.string())) + '-';
+    file.version_prefix =
+        file.source_prefix + hex(fnv1a(version.str())) + '-';
+    file.path = fs::path(*options.cache_dir) /
+                (file.version_prefix + hex(fnv1a(key.str())) + ".arrow");
+    return file;
+}
+
+// remove the source's cache files from earlier versions of it, best effort
+void prune_cache(const CacheFile &file) {
+    std::error_code ec, remove_ec;
+    fs::directory_iterator it(file.path.parent_path(), ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+        auto name = it->path().filename().string();
+        if (name.starts_with(file.source_prefix) &&
+            !name.starts_with(file.version_prefix) && name.ends_with(".arrow"))
+            fs::remove(it->path(), remove_ec);
+    }
+}
+
+// written to a temporary file then renamed so readers never see a partial
+// cache file
+Status write_cache(const shared_ptr<Table> &table, const fs::path &path) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    if (ec) {
+        return Status::IOError("Cannot create ", path.parent_path().string(),
+                               ": ", ec.message());
+    }
+    auto tmp = path;
+    tmp += ".tmp" + std::to_string(getpid()) + "-" +
+           std::to_string(
+               std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    auto write = [&]() -> Status {
+        ARROW_ASSIGN_OR_RAISE(auto output,
+                              arrow::io::FileOutputStream::Open(tmp.string()));
+        ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(
+                                               output, table->schema()));
+        ARROW_RETURN_NOT_OK(writer->WriteTable(*table));
+        ARROW_RETURN_NOT_OK(writer->Close());
+        ARROW_RETURN_NOT_OK(output->Close());
+
+        fs::rename(tmp, path, ec);
+        if (ec) {
+            return Status::IOError("Cannot rename ", tmp.string(), ": ",
+                                   ec.message());
+        }
+        return Status::OK();
+    };
+    auto status = write();
+    if (!status.ok()) fs::remove(tmp, ec);
+    return status;
+}
+
+}  // namespace
+
+Result<shared_ptr<Table>> FilterDateRange(const shared_ptr<Table> &table,
+                                          const LoadOptions &options) {
+    if (!options.start && !options.end) return table;
+
+    auto date = table->GetColumnByName(options.date_column);
+    if (!date) {
+        return Status::KeyError("Date column not found: ",
+                                options.date_column);
+    }
+
+    // compare in nanoseconds, keeping any timezone
+    auto ns_type = arrow::timestamp(arrow::TimeUnit::NANO);
+    if (date->type()->id() == arrow::Type::TIMESTAMP) {
+        ns_type = arrow::timestamp(
+            arrow::TimeUnit::NANO,
+            static_cast<const arrow::TimestampType &>(*date->type())
+                .timezone());
+    }
+    ARROW_ASSIGN_OR_RAISE(auto dates, arrow::compute::Cast(date, ns_type));
+
+    Datum mask;
+    auto bound = [&](const char *function, const time_point<system_clock> &tp)
+        -> Result<Datum> {
+        auto scalar = std::make_shared<arrow::TimestampScalar>(to_ns(tp),
+                                                               ns_type);
+        ARROW_ASSIGN_OR_RAISE(auto m, arrow::compute::CallFunction(
+                                          function, {dates, Datum(scalar)}));
+        if (mask.is_value()) {
+            return arrow::compute::And(mask, m);
+        }
+        return m;
+    };
+    if (options.start) {
+        ARROW_ASSIGN_OR_RAISE(mask, bound("greater_equal", *options.start));
+    }
+    if (options.end) {
+        ARROW_ASSIGN_OR_RAISE(mask, bound("less", *options.end));
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto filtered, arrow::compute::Filter(table, mask));
+    return filtered.table();
+}
+
+vector<int> SelectFields(const shared_ptr<arrow::Schema> &schema,
+                         const LoadOptions &options) {
+    vector<int> indices;
+    for (int i = 0; i < schema->num_fields(); ++i) {
+        if (keep_column(schema->field(i)->name(), options))
+            indices.push_back(i);
+    }
+    return indices;
+}
+
+Result<shared_ptr<Table>> LoadParquetTable(const string &path,
+                                           const LoadOptions &options) {
+    arrow::MemoryPool *pool = arrow::default_memory_pool();
+    ARROW_ASSIGN_OR_RAISE(auto input, open_input(path, options));
+
+    // Open Parquet file reader
+    parquet::ArrowReaderProperties arrow_props;
+    arrow_props.set_use_threads(options.use_threads);
+
+    parquet::arrow::FileReaderBuilder builder;
+    ARROW_RETURN_NOT_OK(builder.Open(input));
+    std::unique_ptr<parquet::arrow::FileReader> arrow_reader;
+    ARROW_RETURN_NOT_OK(
+        builder.memory_pool(pool)->properties(arrow_props)->Build(
+            &arrow_reader));
+
+    // Read entire file as a single Arrow table
+    shared_ptr<Table> table;
+    if (!options.selects_columns() && !options.start && !options.end) {
+        ARROW_RETURN_NOT_OK(arrow_reader->ReadTable(&table));
+        return table;
+    }
+
+    shared_ptr<arrow::Schema> schema;
+    ARROW_RETURN_NOT_OK(arrow_reader->GetSchema(&schema));
+    auto metadata = arrow_reader->parquet_reader()->metadata();
+
+    // projected columns as parquet leaf indices (our tables are flat)
+    vector<int> leaves;
+    arrow::FieldVector fields;
+    for (auto i : SelectFields(schema, options)) {
+        auto &field = schema->field(i);
+        auto leaf = metadata->schema()->ColumnIndex(field->name());
+        if (leaf < 0) {
+            return Status::NotImplemented("Nested column: ", field->name());
+        }
+        leaves.push_back(leaf);
+        fields.push_back(field);
+    }
+
+    // row groups that may hold dates in range
+    vector<int> row_groups;
+    auto date_field = schema->GetFieldByName(options.date_column);
+    auto date_leaf = metadata->schema()->ColumnIndex(options.date_column);
+    for (int rg = 0; rg < metadata->num_row_groups(); ++rg) {
+        if (date_field && date_leaf >= 0 &&
+            date_field->type()->id() == arrow::Type::TIMESTAMP &&
+            !row_group_in_range(
+                *metadata, rg, date_leaf,
+                static_cast<const arrow::TimestampType &>(*date_field->type()),
+                options))
+            continue;
+        row_groups.push_back(rg);
+    }
+
+    if (row_groups.empty()) {
+        ARROW_ASSIGN_OR_RAISE(table, Table::MakeEmpty(arrow::schema(
+                                         fields, schema->metadata())));
+    } else {
+        ARROW_RETURN_NOT_OK(
+            arrow_reader->ReadRowGroups(row_groups, leaves, &table));
+    }
+    return FilterDateRange(table, options);
+}
+
+Result<shared_ptr<Table>> LoadOrcTable(const string &path,
+                                       const LoadOptions &options) {
+    ARROW_ASSIGN_OR_RAISE(auto input, open_input(path, options));
+    ARROW_ASSIGN_OR_RAISE(
+        auto reader, arrow::adapters::orc::ORCFileReader::Open(
+                         input, arrow::default_memory_pool()));
+
+    shared_ptr<Table> table;
+    if (options.selects_columns()) {
+        ARROW_ASSIGN_OR_RAISE(auto schema, reader->ReadSchema());
+        vector<string> names;
+        for (auto i : SelectFields(schema, options))
+            names.push_back(schema->field(i)->name());
+        ARROW_ASSIGN_OR_RAISE(table, reader->Read(names));
+    } else {
+        ARROW_ASSIGN_OR_RAISE(table, reader->Read());
+    }
+    return FilterDateRange(table, options);
+}
+
+Result<shared_ptr<Table>> LoadIpcTable(const string &path,
+                                       const LoadOptions &options) {
+    ARROW_ASSIGN_OR_RAISE(auto input, open_input(path, options));
+    ARROW_ASSIGN_OR_RAISE(auto reader,
+                          arrow::ipc::feather::Reader::Open(input));
+
+    shared_ptr<Table> table;
+    if (options.selects_columns()) {
+        ARROW_RETURN_NOT_OK(
+            reader->Read(SelectFields(reader->schema(), options), &table));
+    } else {
+        ARROW_RETURN_NOT_OK(reader->Read(&table));
+    }
+    return FilterDateRange(table, options);
+}
+
+Result<shared_ptr<Table>> NormalizeDates(const shared_ptr<Table> &table,
+                                         const LoadOptions &options) {
+    auto date_index = table->schema()->GetFieldIndex(options.date_column);
+    if (date_index < 0) return table;
+
+    // keeping any timezone
+    auto &field = table->schema()->field(date_index);
+    auto ns_type = arrow::timestamp(arrow::TimeUnit::NANO);
+    if (field->type()->id() == arrow::Type::TIMESTAMP) {
+        ns_type = arrow::timestamp(
+            arrow::TimeUnit::NANO,
+            static_cast<const arrow::TimestampType &>(*field->type())
+                .timezone());
+    }
+    if (field->type()->Equals(ns_type)) return table;
+
+    ARROW_ASSIGN_OR_RAISE(
+        auto date, arrow::compute::Cast(table->column(date_index), ns_type));
+    return table->SetColumn(date_index, field->WithType(ns_type),
+                            date.chunked_array());
+}
+
+Result<shared_ptr<Table>> PrepareTable(const shared_ptr<Table> &table,
+                                       const LoadOptions &options) {
+    ARROW_ASSIGN_OR_RAISE(auto normalized, NormalizeDates(table, options));
+    return normalized->CombineChunks();
+}
+
+Result<shared_ptr<Table>> LoadTable(const string &path,
+                                    const LoadOptions &options) {
+    auto format = resolve_format(path, options);
+    auto load = [&]() -> Result<shared_ptr<Table>> {
+        switch (format) {
+            case FileFormat::ORC:
+                return LoadOrcTable(path, options);
+            case FileFormat::IPC:
+                return LoadIpcTable(path, options);
+            default:
+                return LoadParquetTable(path, options);
+        }
+    };
+    if (!options.cache_dir) {
+        ARROW_ASSIGN_OR_RAISE(auto table, load());
+        return NormalizeDates(table, options);
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto cached, cache_file(path, format, options));
+    if (fs::exists(cached.path)) {
+        LoadOptions mapped;
+        mapped.memory_map = true;
+        return LoadIpcTable(cached.path.string(), mapped);
+    }
+
+    // the table is loaded either way, a cache that can't be written only
+    // costs the next load
+    ARROW_ASSIGN_OR_RAISE(auto table, load());
+    ARROW_ASSIGN_OR_RAISE(table, PrepareTable(table, options));
+    if (auto st_wc = write_cache(table, cached.path); !st_wc.ok()) {
+        LOG(WARNING) << "Cannot write load cache " << cached.path << ": "
+                     << st_wc;
+        return table;
+    }
+    prune_cache(cached);
+    return table;
+}
+
+}  // namespace YABTE::Utilities::Arrow
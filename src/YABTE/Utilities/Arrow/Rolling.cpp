@@ -0,0 +1,423 @@
+#include "YABTE/Utilities/Arrow/Rolling.hpp"
+
+#include <arrow/util/bit_util.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using std::vector, std::make_shared;
+
+using arrow::Status, arrow::Buffer;
+
+namespace YABTE::Utilities::Arrow {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// contiguous doubles for a numeric column with missing values as NaN. a
+// single chunk float64 column without nulls is used in place.
+struct DoubleInput {
+    const double *data = nullptr;
+    int64_t length = 0;
+    vector<double> storage;
+    shared_ptr<arrow::Array> keep_alive;
+};
+
+template <typename T>
+void widen(const T *src, const int64_t n, double *dst) {
+    for (int64_t i = 0; i < n; ++i) dst[i] = static_cast<double>(src[i]);
+}
+
+Status MakeInput(const shared_ptr<ChunkedArray> &vals, DoubleInput &in) {
+    in.length = vals->length();
+
+    if (vals->num_chunks() == 1 && vals->type()->id() == arrow::Type::DOUBLE &&
+        vals->null_count() == 0) {
+        in.keep_alive = vals->chunk(0);
+        in.data = static_cast<const arrow::DoubleArray &>(*in.keep_alive)
+                      .raw_values();
+        return Status::OK();
+    }
+
+    in.storage.resize(in.length);
+    double *out = in.storage.data();
+    for (auto const &chunk : vals->chunks()) {
+        auto n = chunk->length();
+        switch (chunk->type_id()) {
+            case arrow::Type::DOUBLE:
+                widen(static_cast<const arrow::DoubleArray &>(*chunk)
+                          .raw_values(),
+                      n, out);
+                break;
+            case arrow::Type::FLOAT:
+                widen(
+                    static_cast<const arrow::FloatArray &>(*chunk).raw_values(),
+                    n, out);
+                break;
+            case arrow::Type::INT64:
+                widen(
+                    static_cast<const arrow::Int64Array &>(*chunk).raw_values(),
+                    n, out);
+                break;
+            case arrow::Type::INT32:
+                widen(
+                    static_cast<const arrow::Int32Array &>(*chunk).raw_values(),
+                    n, out);
+                break;
+            default:
+                return Status::TypeError("Rolling kernels need a numeric ",
+                                         "column, got ",
+                                         chunk->type()->ToString());
+        }
+        if (chunk->null_count() > 0) {
+            for (int64_t i = 0; i < n; ++i)
+                if (chunk->IsNull(i)) out[i] = kNaN;
+        }
+        out += n;
+    }
+    in.data = in.storage.data();
+    return Status::OK();
+}
+
+Result<shared_ptr<Buffer>> AllocateDoubles(const int64_t n) {
+    ARROW_ASSIGN_OR_RAISE(auto buffer,
+                          arrow::AllocateBuffer(n * sizeof(double)));
+    return shared_ptr<Buffer>(std::move(buffer));
+}
+
+// wrap computed values as a float64 array, NaNs become nulls
+Result<shared_ptr<ChunkedArray>> FinishDoubles(
+    const shared_ptr<Buffer> &values, const int64_t n) {
+    auto out = reinterpret_cast<const double *>(values->data());
+
+    ARROW_ASSIGN_OR_RAISE(auto bitmap, arrow::AllocateEmptyBitmap(n));
+    auto bits = bitmap->mutable_data();
+    int64_t null_count = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        auto valid = out[i] == out[i];
+        arrow::bit_util::SetBitTo(bits, i, valid);
+        null_count += !valid;
+    }
+
+    auto data = arrow::ArrayData::Make(
+        arrow::float64(), n,
+        {null_count > 0 ? shared_ptr<Buffer>(std::move(bitmap)) : nullptr,
+         values},
+        null_count);
+    return make_shared<ChunkedArray>(arrow::MakeArray(data));
+}
+
+Status CheckWindow(const int64_t window, int64_t &min_periods) {
+    if (window <= 0) return Status::Invalid("Window must be positive");
+    if (min_periods < 0) min_periods = window;
+    if (min_periods > window)
+        return Status::Invalid("min_periods must not exceed window");
+    return Status::OK();
+}
+
+// Neumaier compensated running sum, keeps add/remove drift down on long
+// columns
+struct CompensatedSum {
+    double sum = 0., comp = 0.;
+
+    void add(const double v) {
+        auto t = sum + v;
+        if (std::abs(sum) >= std::abs(v))
+            comp += (sum - t) + v;
+        else
+            comp += (v - t) + sum;
+        sum = t;
+    }
+    double value() const { return sum + comp; }
+};
+
+void rolling_sum(const double *x, const int64_t n, const int64_t window,
+                 const int64_t min_periods, const bool mean, double *out) {
+    CompensatedSum s;
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        if (auto v = x[i]; v == v) {
+            s.add(v);
+            ++count;
+        }
+        if (i >= window) {
+            if (auto u = x[i - window]; u == u) {
+                s.add(-u);
+                if (--count == 0) s = CompensatedSum();
+            }
+        }
+        if (count < min_periods || (mean && count == 0))
+            out[i] = kNaN;
+        else
+            out[i] = mean ? s.value() / count : s.value();
+    }
+}
+
+// Welford mean and sum of squared deviations with removal
+struct Moments {
+    int64_t count = 0;
+    double mean = 0., m2 = 0.;
+
+    void add(const double v) {
+        ++count;
+        auto d = v - mean;
+        mean += d / count;
+        m2 += d * (v - mean);
+    }
+    void remove(const double v) {
+        if (--count == 0) {
+            mean = m2 = 0.;
+            return;
+        }
+        auto d = v - mean;
+        mean -= d / count;
+        m2 -= d * (v - mean);
+    }
+};
+
+// either output may be null
+void rolling_moments(const double *x, const int64_t n, const int64_t window,
+                     const int64_t min_periods, const int ddof,
+                     double *mean_out, double *var_out) {
+    Moments m;
+    for (int64_t i = 0; i < n; ++i) {
+        if (i >= window)
+            if (auto u = x[i - window]; u == u) m.remove(u);
+        if (auto v = x[i]; v == v) m.add(v);
+
+        auto ok = m.count >= min_periods && m.count > 0;
+        if (mean_out) mean_out[i] = ok ? m.mean : kNaN;
+        if (var_out)
+            var_out[i] = ok && m.count > ddof
+                             ? std::max(m.m2, 0.) / (m.count - ddof)
+                             : kNaN;
+    }
+}
+
+// better(a, b) is true when a should stay in front of b
+template <typename Better>
+void rolling_extreme(const double *x, const int64_t n, const int64_t window,
+                     const int64_t min_periods, Better better, double *out) {
+    // monotonic deque of positions held in a ring buffer, at most window
+    // positions are live at once
+    vector<int64_t> ring(window);
+    int64_t head = 0, size = 0, count = 0;
+
+    for (int64_t i = 0; i < n; ++i) {
+        if (i >= window) {
+            if (x[i - window] == x[i - window]) --count;
+            if (size > 0 && ring[head] == i - window) {
+                head = (head + 1) % window;
+                --size;
+            }
+        }
+        if (auto v = x[i]; v == v) {
+            ++count;
+            while (size > 0 &&
+                   !better(x[ring[(head + size - 1) % window]], v))
+                --size;
+            ring[(head + size) % window] = i;
+            ++size;
+        }
+        out[i] =
+            size > 0 && count >= min_periods ? x[ring[head]] : kNaN;
+    }
+}
+
+void rolling_rank(const double *x, const int64_t n, const int64_t window,
+                  const int64_t min_periods, double *out) {
+    // distinct valid values, so each value has a dense key
+    vector<double> keys;
+    keys.reserve(n);
+    for (int64_t i = 0; i < n; ++i)
+        if (x[i] == x[i]) keys.push_back(x[i]);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    auto key = [&](const double v) {
+        return std::lower_bound(keys.begin(), keys.end(), v) - keys.begin();
+    };
+
+    // fenwick tree of the window's valid values by key, counts of values
+    // below a key are O(log n)
+    vector<int64_t> tree(keys.size() + 1, 0);
+    auto add = [&](int64_t k, const int64_t delta) {
+        for (++k; k < std::ssize(tree); k += k & -k) tree[k] += delta;
+    };
+    auto below = [&](int64_t k) {
+        int64_t total = 0;
+        for (; k > 0; k -= k & -k) total += tree[k];
+        return total;
+    };
+
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        if (i >= window) {
+            if (auto u = x[i - window]; u == u) {
+                add(key(u), -1);
+                --count;
+            }
+        }
+        auto v = x[i];
+        if (v != v) {
+            out[i] = kNaN;
+            continue;
+        }
+        auto k = key(v);
+        add(k, 1);
+        ++count;
+
+        if (count < min_periods) {
+            out[i] = kNaN;
+            continue;
+        }
+        // mean of ranks lo+1..hi
+        out[i] = 0.5 * (below(k) + below(k + 1) + 1);
+    }
+}
+
+template <typename Kernel>
+Result<shared_ptr<ChunkedArray>> Run(const shared_ptr<ChunkedArray> &vals,
+                                     Kernel kernel) {
+    DoubleInput in;
+    ARROW_RETURN_NOT_OK(MakeInput(vals, in));
+    ARROW_ASSIGN_OR_RAISE(auto values, AllocateDoubles(in.length));
+    kernel(in.data, in.length, reinterpret_cast<double *>(
+                                   values->mutable_data()));
+    return FinishDoubles(values, in.length);
+}
+
+}  // namespace
+
+Result<shared_ptr<ChunkedArray>> RollingSum(
+    const shared_ptr<ChunkedArray> &vals, int64_t window, int64_t min_periods) {
+    ARROW_RETURN_NOT_OK(CheckWindow(window, min_periods));
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        rolling_sum(x, n, window, min_periods, false, out);
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> RollingMean(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods) {
+    ARROW_RETURN_NOT_OK(CheckWindow(window, min_periods));
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        rolling_sum(x, n, window, min_periods, true, out);
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> RollingVar(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods, int ddof) {
+    ARROW_RETURN_NOT_OK(CheckWindow(window, min_periods));
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        rolling_moments(x, n, window, min_periods, ddof, nullptr, out);
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> RollingStd(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods, int ddof) {
+    ARROW_RETURN_NOT_OK(CheckWindow(window, min_periods));
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        rolling_moments(x, n, window, min_periods, ddof, nullptr, out);
+        for (int64_t i = 0; i < n; ++i) out[i] = std::sqrt(out[i]);
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> RollingMin(
+    const shared_ptr<ChunkedArray> &vals, int64_t window, int64_t min_periods) {
+    ARROW_RETURN_NOT_OK(CheckWindow(window, min_periods));
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        rolling_extreme(
+            x, n, window, min_periods,
+            [](double a, double b) { return a < b; }, out);
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> RollingMax(
+    const shared_ptr<ChunkedArray> &vals, int64_t window, int64_t min_periods) {
+    ARROW_RETURN_NOT_OK(CheckWindow(window, min_periods));
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        rolling_extreme(
+            x, n, window, min_periods,
+            [](double a, double b) { return a > b; }, out);
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> RollingZScore(
+    const shared_ptr<ChunkedArray> &vals, int64_t window, int64_t min_periods,
+    int ddof) {
+    ARROW_RETURN_NOT_OK(CheckWindow(window, min_periods));
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        vector<double> var(n);
+        rolling_moments(x, n, window, min_periods, ddof, out, var.data());
+        for (int64_t i = 0; i < n; ++i) {
+            auto sd = std::sqrt(var[i]);
+            out[i] = sd > 0. ? (x[i] - out[i]) / sd : kNaN;
+        }
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> RollingRank(
+    const shared_ptr<ChunkedArray> &vals, int64_t window,
+    int64_t min_periods) {
+    ARROW_RETURN_NOT_OK(CheckWindow(window, min_periods));
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        rolling_rank(x, n, window, min_periods, out);
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> ExponentialMovingAverage(
+    const shared_ptr<ChunkedArray> &vals, double span, int64_t min_periods) {
+    if (!(span >= 1.)) return Status::Invalid("Span must be at least 1");
+    auto alpha = 2. / (span + 1.);
+    return Run(vals, [&](const double *x, int64_t n, double *out) {
+        auto y = kNaN;
+        int64_t count = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            if (auto v = x[i]; v == v) {
+                y = count++ == 0 ? v : (1. - alpha) * y + alpha * v;
+            }
+            out[i] = count >= min_periods && count > 0 ? y : kNaN;
+        }
+    });
+}
+
+Result<shared_ptr<ChunkedArray>> Crossover(const shared_ptr<ChunkedArray> &a,
+                                           const shared_ptr<ChunkedArray> &b) {
+    if (a->length() != b->length())
+        return Status::Invalid("Crossover needs columns of equal length");
+
+    DoubleInput x, y;
+    ARROW_RETURN_NOT_OK(MakeInput(a, x));
+    ARROW_RETURN_NOT_OK(MakeInput(b, y));
+    auto n = x.length;
+
+    ARROW_ASSIGN_OR_RAISE(auto values, arrow::AllocateEmptyBitmap(n));
+    ARROW_ASSIGN_OR_RAISE(auto validity, arrow::AllocateEmptyBitmap(n));
+    auto value_bits = values->mutable_data();
+    auto valid_bits = validity->mutable_data();
+
+    int64_t null_count = n > 0 ? 1 : 0;
+    for (int64_t i = 1; i < n; ++i) {
+        auto x0 = x.data[i - 1], y0 = y.data[i - 1];
+        auto x1 = x.data[i], y1 = y.data[i];
+        // NaN compares unequal to itself
+        auto valid = x0 == x0 && y0 == y0 && x1 == x1 && y1 == y1;
+        arrow::bit_util::SetBitTo(valid_bits, i, valid);
+        arrow::bit_util::SetBitTo(value_bits, i, valid && x0 < y0 && x1 > y1);
+        null_count += !valid;
+    }
+
+    auto data = arrow::ArrayData::Make(
+        arrow::boolean(), n,
+        {null_count > 0 ? shared_ptr<Buffer>(std::move(validity)) : nullptr,
+         shared_ptr<Buffer>(std::move(values))},
+        null_count);
+    return make_shared<ChunkedArray>(arrow::MakeArray(data));
+}
+
+}  // namespace YABTE::Utilities::Arrow
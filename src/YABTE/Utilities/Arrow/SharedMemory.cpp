@@ -0,0 +1,121 @@
+#include "YABTE/Utilities/Arrow/SharedMemory.hpp"
+
+#include <arrow/io/memory.h>
+#include <arrow/ipc/api.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+using std::make_shared, std::vector;
+
+using arrow::Status;
+
+namespace YABTE::Utilities::Arrow {
+
+namespace {
+
+Status ErrnoStatus(const char *call, const string &name) {
+    return Status::IOError(call, " ", name, ": ", std::strerror(errno));
+}
+
+Status WriteIpcFile(const Table &table, arrow::io::OutputStream *sink) {
+    ARROW_ASSIGN_OR_RAISE(auto writer,
+                          arrow::ipc::MakeFileWriter(sink, table.schema()));
+    ARROW_RETURN_NOT_OK(writer->WriteTable(table));
+    return writer->Close();
+}
+
+// a read only mapping, unmapped with the buffer (and so with the last
+// slice of it, which ipc reads make for each array buffer)
+class MappedBuffer : public arrow::Buffer {
+   public:
+    MappedBuffer(const uint8_t *data, const int64_t size)
+        : arrow::Buffer(data, size) {}
+    ~MappedBuffer() override {
+        munmap(const_cast<uint8_t *>(this->data_), this->size_);
+    }
+};
+
+string UniqueName() {
+    static std::atomic<int64_t> counter = 0;
+    return "/yabte_" + std::to_string(getpid()) + "_" +
+           std::to_string(counter++);
+}
+
+}  // namespace
+
+Result<shared_ptr<SharedTable>> SharedTable::Publish(
+    const shared_ptr<Table> &table, const string &name) {
+    auto shm_name = name.empty() ? UniqueName() : name;
+    // one record batch, so mapped columns are single chunks that table
+    // views use in place
+    ARROW_ASSIGN_OR_RAISE(auto combined, table->CombineChunks());
+
+    // size of the ipc file, by writing it to a stream that only counts
+    arrow::io::MockOutputStream counter;
+    ARROW_RETURN_NOT_OK(WriteIpcFile(*combined, &counter));
+    ARROW_ASSIGN_OR_RAISE(auto size, counter.Tell());
+
+    auto fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return ErrnoStatus("shm_open", shm_name);
+    // owns the name from here, so it is unlinked on error too
+    shared_ptr<SharedTable> shared(new SharedTable(shm_name, size));
+
+    auto st = [&]() -> Status {
+        if (ftruncate(fd, size) != 0)
+            return ErrnoStatus("ftruncate", shm_name);
+        auto addr =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) return ErrnoStatus("mmap", shm_name);
+        auto buffer = make_shared<arrow::MutableBuffer>(
+            static_cast<uint8_t *>(addr), size);
+        arrow::io::FixedSizeBufferWriter writer(buffer);
+        auto st = WriteIpcFile(*combined, &writer);
+        munmap(addr, size);
+        return st;
+    }();
+    close(fd);
+    ARROW_RETURN_NOT_OK(st);
+    return shared;
+}
+
+Result<shared_ptr<Table>> SharedTable::Map(const string &name) {
+    auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return ErrnoStatus("shm_open", name);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        auto st = ErrnoStatus("fstat", name);
+        close(fd);
+        return st;
+    }
+    auto addr = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return ErrnoStatus("mmap", name);
+    auto buffer = make_shared<MappedBuffer>(static_cast<uint8_t *>(addr),
+                                            info.st_size);
+
+    // a buffer reader hands out slices of the buffer, so the batches
+    // reference the mapping rather than copies. nothing is decoded, so
+    // arrow's thread pool isn't used (a forked child may not have it)
+    auto input = make_shared<arrow::io::BufferReader>(buffer);
+    auto options = arrow::ipc::IpcReadOptions::Defaults();
+    options.use_threads = false;
+    ARROW_ASSIGN_OR_RAISE(
+        auto reader, arrow::ipc::RecordBatchFileReader::Open(input, options));
+    vector<shared_ptr<arrow::RecordBatch>> batches;
+    for (int i = 0; i < reader->num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadRecordBatch(i));
+        batches.push_back(batch);
+    }
+    return Table::FromRecordBatches(reader->schema(), batches);
+}
+
+SharedTable::~SharedTable() { shm_unlink(this->name_.c_str()); }
+
+}  // namespace YABTE::Utilities::Arrow
@@ -4,60 +4,81 @@
 #include <arrow/compute/api.h>
 #include <arrow/json/reader.h>
 #include <glog/logging.h>
-#include <parquet/arrow/reader.h>
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <ranges>
 
+#include "YABTE/Utilities/Arrow/Join.hpp"
+#include "YABTE/Utilities/Arrow/Rolling.hpp"
+
 using std::dynamic_pointer_cast, std::exception, std::shared_ptr, std::vector,
-    std::views::iota, std::string_literals::operator""s, std::make_shared,
-    std::string;
+    std::string_literals::operator""s, std::make_shared, std::string;
 
 namespace YABTE::Utilities::Arrow {
 
-Result<shared_ptr<Table>> LoadTable(string path) {
-    arrow::MemoryPool* pool = arrow::default_memory_pool();
-    shared_ptr<arrow::io::RandomAccessFile> input;
-    ARROW_ASSIGN_OR_RAISE(input, arrow::io::ReadableFile::Open(path));
-
-    // Open Parquet file reader
-    std::unique_ptr<parquet::arrow::FileReader> arrow_reader;
-    ARROW_RETURN_NOT_OK(parquet::arrow::OpenFile(input, pool, &arrow_reader));
-
-    // Read entire file as a single Arrow table
-    shared_ptr<Table> table;
-    ARROW_RETURN_NOT_OK(arrow_reader->ReadTable(&table));
-    return table;
-}
-
 Result<shared_ptr<ChunkedArray>> ComputeMovingAverage(
     shared_ptr<ChunkedArray> vals, int n) {
-    // calculate moving average vector
-    vector<double> ma(n, std::nan(""));
-
-    // rows 0..9, 1..10, 2..11, ..., size-n-1..size-1
-    for (int x : iota(0, vals->length() - n)) {
-        auto slice = vals->Slice(x, n);
-        arrow::Datum sum;
-        ARROW_ASSIGN_OR_RAISE(sum, arrow::compute::Mean({slice}));
-        ma.push_back(sum.scalar_as<arrow::DoubleScalar>().value);
+    // NOTE: the value at row i is the mean of rows i-n..i-1 (RollingMean
+    //       includes row i), so shift the rolling mean down a row.
+    ARROW_ASSIGN_OR_RAISE(auto ma, RollingMean(vals, n, 1));
+    auto &means = static_cast<const arrow::DoubleArray &>(*ma->chunk(0));
+
+    // leading rows (and empty windows) are NaN rather than null, as they
+    // always have been for existing strategies
+    auto len = vals->length();
+    vector<double> out(len, std::nan(""));
+    for (int64_t i = n; i < len; ++i) {
+        if (means.IsValid(i - 1)) out[i] = means.Value(i - 1);
     }
 
-    // convert vector to arrow array
-    shared_ptr<arrow::Array> ma_arr;
-    arrow::DoubleBuilder dbl_builder = arrow::DoubleBuilder();
+    arrow::DoubleBuilder dbl_builder;
+    ARROW_RETURN_NOT_OK(dbl_builder.AppendValues(out));
+    ARROW_ASSIGN_OR_RAISE(auto ma_arr, dbl_builder.Finish());
+    return make_shared<ChunkedArray>(ma_arr);
+}
 
-    ARROW_RETURN_NOT_OK(dbl_builder.AppendValues(ma.begin(), ma.end()));
-    ARROW_ASSIGN_OR_RAISE(ma_arr, dbl_builder.Finish());
+std::optional<std::tuple<string, string>> ParseColumnName(const string& name) {
+    // equivalent to the regex ^\('(\S+)', '(\S+)'\)$
+    const string head = "('", sep = "', '", tail = "')";
 
-    return make_shared<ChunkedArray>(ma_arr);
+    if (name.size() < head.size() + sep.size() + tail.size() + 2 ||
+        !name.starts_with(head) || !name.ends_with(tail))
+        return std::nullopt;
+
+    auto inner = name.substr(head.size(),
+                             name.size() - head.size() - tail.size());
+    auto pos = inner.find(sep);
+    if (pos == string::npos) return std::nullopt;
+
+    auto label = inner.substr(0, pos);
+    auto field = inner.substr(pos + sep.size());
+
+    auto non_space = [](const string& s) {
+        return !s.empty() && std::none_of(s.begin(), s.end(), [](char c) {
+            return std::isspace(static_cast<unsigned char>(c));
+        });
+    };
+    if (!non_space(label) || !non_space(field)) return std::nullopt;
+
+    return std::tuple<string, string>{label, field};
 }
 
-// NOTE: This function assumes the first column of both tables are identical.
-//       More specifically, this is a naive join in the simplest scenario.
 Result<shared_ptr<Table>> ExtendTable(
     const shared_ptr<const Table>& base_table,
-    const shared_ptr<const Table>& ext_table) {
+    const shared_ptr<const Table>& ext_table,
+    const optional<AsOfJoinOptions>& as_of) {
+    // irregular data carries its own dates, align it on base's
+    if (as_of) {
+        ARROW_ASSIGN_OR_RAISE(auto aligned,
+                              AsOfAlign(base_table, ext_table, *as_of));
+        return ExtendTable(base_table, aligned);
+    }
+    if (ext_table->num_rows() != base_table->num_rows()) {
+        return Status::Invalid("Tables must have the same number of rows.");
+    }
+
     // merge schema metadata from both tables
     auto ext_schema = ext_table->schema();
     auto base_schema = base_table->schema();
@@ -0,0 +1,122 @@
+#include "YABTE/Utilities/Concurrency/Executor.hpp"
+
+#include <glog/logging.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace YABTE::Utilities::Concurrency {
+
+thread_local const Executor *Executor::current_ = nullptr;
+thread_local int Executor::current_index_ = -1;
+
+Executor::Executor(const ExecutorOptions &options) {
+    auto num_threads = options.num_threads
+                           ? options.num_threads
+                           : std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned i = 0; i < num_threads; ++i)
+        this->workers_.push_back(std::make_unique<Worker>());
+    // start only once every deque exists, workers steal from all of them
+    for (unsigned i = 0; i < num_threads; ++i) {
+        this->workers_[i]->thread = std::thread(
+            &Executor::_worker_loop, this, static_cast<int>(i),
+            options.pin_threads);
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(this->wait_mutex_);
+        this->stop_ = true;
+    }
+    this->wake_.notify_all();
+    for (auto &worker : this->workers_) worker->thread.join();
+}
+
+Executor &Executor::shared() {
+    static Executor executor;
+    static const pid_t pid = getpid();
+    if (getpid() == pid) return executor;
+
+    // a forked child has none of the parent's worker threads, it gets an
+    // executor of its own that is never joined (such children _exit)
+    static Executor *forked = nullptr;
+    static pid_t forked_pid = 0;
+    if (forked_pid != getpid()) {
+        forked = new Executor();
+        forked_pid = getpid();
+    }
+    return *forked;
+}
+
+void Executor::_push(Task task) {
+    auto index = this->worker_index();
+    if (index < 0) index = this->next_worker_++ % this->workers_.size();
+
+    auto &worker = *this->workers_[index];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    {
+        // under the wait lock so a worker about to sleep sees the task
+        std::lock_guard<std::mutex> lock(this->wait_mutex_);
+        ++this->pending_;
+    }
+    this->wake_.notify_one();
+}
+
+bool Executor::_try_run_one(const int index) {
+    auto n = this->workers_.size();
+    Task task;
+    for (size_t k = 0; k < n && !task; ++k) {
+        auto &worker = *this->workers_[(index + k) % n];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) continue;
+        if (k == 0) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        } else {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+
+    --this->pending_;
+    task();
+    return true;
+}
+
+void Executor::_worker_loop(const int index, const bool pin) {
+    current_ = this;
+    current_index_ = index;
+
+#ifdef __linux__
+    if (pin) {
+        auto cpus = std::max(std::thread::hardware_concurrency(), 1u);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cpus, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            LOG(WARNING) << "Could not pin executor worker " << index;
+    }
+#else
+    if (pin) LOG(WARNING) << "Executor thread pinning not supported";
+#endif
+
+    while (true) {
+        if (this->_try_run_one(index)) continue;
+
+        std::unique_lock<std::mutex> lock(this->wait_mutex_);
+        this->wake_.wait(lock, [this] {
+            return this->stop_ || this->pending_ > 0;
+        });
+        if (this->stop_ && this->pending_ == 0) return;
+    }
+}
+
+}  // namespace YABTE::Utilities::Concurrency
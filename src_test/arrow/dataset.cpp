@@ -0,0 +1,186 @@
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <gtest/gtest.h>
+#include <parquet/arrow/writer.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "YABTE/BackTest/common.hpp"
+#include "YABTE/Utilities/Arrow/Dataset.hpp"
+#include "YABTE/Utilities/Arrow/TableHelpers.hpp"
+#include "data/test_data.h"
+
+using std::shared_ptr, std::vector, std::string,
+    std::string_literals::operator""s;
+
+using YABTE::Utilities::Arrow::LoadTable, YABTE::Utilities::Arrow::LoadDataset,
+    YABTE::Utilities::Arrow::DatasetOptions;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const vector<string> fields{"Open", "High", "Low", "Close", "Volume"};
+
+string wide_name(const string &asset, const string &field) {
+    return "('" + asset + "', '" + field + "')";
+}
+
+// rows [offset, offset + length) of an asset from the wide sample table,
+// with unprefixed field names
+shared_ptr<arrow::Table> asset_rows(const shared_ptr<arrow::Table> &wide,
+                                    const string &asset, int64_t offset,
+                                    int64_t length) {
+    arrow::FieldVector out_fields{wide->schema()->GetFieldByName("Date")};
+    arrow::ChunkedArrayVector columns{wide->GetColumnByName("Date")};
+    for (auto &field : fields) {
+        auto column = wide->GetColumnByName(wide_name(asset, field));
+        out_fields.push_back(arrow::field(field, column->type()));
+        columns.push_back(column);
+    }
+    return arrow::Table::Make(arrow::schema(out_fields), columns)
+        ->Slice(offset, length);
+}
+
+void write_parquet(const shared_ptr<arrow::Table> &table,
+                   const fs::path &path) {
+    fs::create_directories(path.parent_path());
+    auto st_out = arrow::io::FileOutputStream::Open(path.string());
+    ASSERT_TRUE(st_out.ok()) << "Error: " << st_out.status();
+    // small row groups so the date range can prune some
+    ASSERT_TRUE(parquet::arrow::WriteTable(*table,
+                                           arrow::default_memory_pool(),
+                                           st_out.ValueOrDie(), 8)
+                    .ok());
+}
+
+class DatasetTest : public testing::Test {
+   protected:
+    void SetUp() override {
+        auto test_data_dir = fs::weakly_canonical(test_data_path());
+        auto np = test_data_dir / "data_sample.parquet";
+        auto st_lt = LoadTable(np.string());
+        ASSERT_TRUE(st_lt.ok()) << "Error: " << st_lt.status();
+        wide_ = st_lt.ValueOrDie();
+
+        // two files (halves) per asset, META's second half misses a row
+        root_ = fs::temp_directory_path() /
+                ("yabte_dataset_" + std::to_string(getpid()));
+        auto n = wide_->num_rows(), half = n / 2;
+        for (auto asset : {"GOOG", "META", "AMZN"}) {
+            auto dir = root_ / ("symbol="s + asset);
+            write_parquet(asset_rows(wide_, asset, 0, half),
+                          dir / "half=0" / "part.parquet");
+            if (asset == "META"s) {
+                write_parquet(asset_rows(wide_, asset, half + 1, n - half - 1),
+                              dir / "half=1" / "part.parquet");
+            } else {
+                write_parquet(asset_rows(wide_, asset, half, n - half),
+                              dir / "half=1" / "part.parquet");
+            }
+        }
+    }
+
+    void TearDown() override { fs::remove_all(root_); }
+
+    shared_ptr<arrow::Table> wide_;
+    fs::path root_;
+};
+
+}  // namespace
+
+TEST_F(DatasetTest, LoadDatasetAligned) {
+    DatasetOptions options;
+    options.assets = {"GOOG", "META"};
+    options.fields = {"Close", "Open"};
+    options.num_threads = 2;
+
+    auto st_ld = LoadDataset(root_.string(), options);
+    ASSERT_TRUE(st_ld.ok()) << "Error: " << st_ld.status();
+    auto table = st_ld.ValueOrDie();
+
+    ASSERT_EQ(table->num_rows(), wide_->num_rows());
+    vector<string> names{"Date",
+                         wide_name("GOOG", "Open"),
+                         wide_name("GOOG", "Close"),
+                         wide_name("META", "Open"),
+                         wide_name("META", "Close")};
+    ASSERT_EQ(table->ColumnNames(), names);
+
+    ASSERT_TRUE(table->GetColumnByName("Date")->Equals(
+        wide_->GetColumnByName("Date")));
+    auto goog = wide_name("GOOG", "Close");
+    ASSERT_TRUE(
+        table->GetColumnByName(goog)->Equals(wide_->GetColumnByName(goog)));
+
+    // the missing META row is null, the rest match
+    auto half = wide_->num_rows() / 2;
+    auto meta = table->GetColumnByName(wide_name("META", "Close"));
+    auto expected = wide_->GetColumnByName(wide_name("META", "Close"));
+    ASSERT_FALSE(meta->GetScalar(half).ValueOrDie()->is_valid);
+    ASSERT_TRUE(meta->Slice(0, half)->Equals(expected->Slice(0, half)));
+    ASSERT_TRUE(meta->Slice(half + 1)->Equals(expected->Slice(half + 1)));
+}
+
+TEST_F(DatasetTest, LoadDatasetDateRange) {
+    auto date_at = [&](int64_t i) {
+        auto scalar =
+            wide_->GetColumnByName("Date")->GetScalar(i).ValueOrDie();
+        return timestamp_from_ns(
+            std::static_pointer_cast<arrow::TimestampScalar>(scalar)->value);
+    };
+
+    DatasetOptions options;
+    options.assets = {"AMZN"};
+    options.start = date_at(3);
+    options.end = date_at(13);
+
+    auto st_ld = LoadDataset(root_.string(), options);
+    ASSERT_TRUE(st_ld.ok()) << "Error: " << st_ld.status();
+    auto table = st_ld.ValueOrDie();
+
+    ASSERT_EQ(table->num_rows(), 10);
+    ASSERT_EQ(table->num_columns(), 1 + fields.size());
+    auto expected = wide_->Slice(3, 10);
+    for (auto &field : fields) {
+        auto name = wide_name("AMZN", field);
+        ASSERT_TRUE(table->GetColumnByName(name)->Equals(
+            expected->GetColumnByName(name)))
+            << name;
+    }
+}
+
+TEST_F(DatasetTest, LoadDatasetTimeZone) {
+    // GOOG's rows with dates in a time zone
+    auto zoned_type =
+        arrow::timestamp(arrow::TimeUnit::NANO, "America/New_York");
+    auto goog = asset_rows(wide_, "GOOG", 0, wide_->num_rows());
+    arrow::ArrayVector chunks;
+    for (auto &chunk : goog->GetColumnByName("Date")->chunks())
+        chunks.push_back(chunk->View(zoned_type).ValueOrDie());
+    auto zoned = goog->SetColumn(0, arrow::field("Date", zoned_type),
+                                 std::make_shared<arrow::ChunkedArray>(
+                                     chunks, zoned_type))
+                     .ValueOrDie();
+    auto root = root_ / "zoned";
+    write_parquet(zoned, root / "symbol=GOOG" / "part.parquet");
+
+    DatasetOptions options;
+    options.fields = {"Close"};
+    auto date = wide_->GetColumnByName("Date")->GetScalar(3).ValueOrDie();
+    options.start = timestamp_from_ns(
+        std::static_pointer_cast<arrow::TimestampScalar>(date)->value);
+
+    auto st_ld = LoadDataset(root.string(), options);
+    ASSERT_TRUE(st_ld.ok()) << "Error: " << st_ld.status();
+    auto table = st_ld.ValueOrDie();
+
+    ASSERT_EQ(table->num_rows(), wide_->num_rows() - 3);
+    auto dates = table->GetColumnByName("Date");
+    ASSERT_TRUE(dates->type()->Equals(zoned_type));
+    ASSERT_TRUE(dates->Equals(zoned->GetColumnByName("Date")->Slice(3)));
+}
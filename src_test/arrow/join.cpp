@@ -0,0 +1,150 @@
+#include <arrow/api.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "YABTE/Utilities/Arrow/Join.hpp"
+#include "YABTE/Utilities/Arrow/TableHelpers.hpp"
+
+using std::shared_ptr, std::vector, std::string;
+
+using YABTE::Utilities::Arrow::AsOfAlign, YABTE::Utilities::Arrow::AsOfJoin,
+    YABTE::Utilities::Arrow::AsOfJoinOptions,
+    YABTE::Utilities::Arrow::AsOfDirection,
+    YABTE::Utilities::Arrow::ExtendTable;
+
+namespace {
+
+// Date (timestamp[ns]) and a double column named name
+shared_ptr<arrow::Table> dated_table(const vector<int64_t> &dates,
+                                     const vector<double> &values,
+                                     const string &name) {
+    arrow::TimestampBuilder date_builder(
+        arrow::timestamp(arrow::TimeUnit::NANO), arrow::default_memory_pool());
+    EXPECT_TRUE(date_builder.AppendValues(dates).ok());
+    arrow::DoubleBuilder value_builder;
+    EXPECT_TRUE(value_builder.AppendValues(values).ok());
+
+    auto schema =
+        arrow::schema({arrow::field("Date", date_builder.type()),
+                       arrow::field(name, arrow::float64())});
+    return arrow::Table::Make(schema,
+                              {date_builder.Finish().ValueOrDie(),
+                               value_builder.Finish().ValueOrDie()});
+}
+
+// values of a double column, NaN for nulls
+vector<double> values(const shared_ptr<arrow::Table> &table,
+                      const string &name) {
+    vector<double> out;
+    auto column = table->GetColumnByName(name);
+    for (int64_t i = 0; i < column->length(); ++i) {
+        auto scalar = column->GetScalar(i).ValueOrDie();
+        out.push_back(
+            scalar->is_valid
+                ? std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value
+                : std::nan(""));
+    }
+    return out;
+}
+
+void expect_values(const vector<double> &actual,
+                   const vector<double> &expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (std::isnan(expected[i]))
+            EXPECT_TRUE(std::isnan(actual[i])) << i;
+        else
+            EXPECT_EQ(actual[i], expected[i]) << i;
+    }
+}
+
+}  // namespace
+
+TEST(JoinTest, AsOfDirections) {
+    auto nan = std::nan("");
+    auto left = dated_table({10, 20, 30, 40, 50}, {1, 2, 3, 4, 5}, "Close");
+    auto right = dated_table({5, 20, 33, 60}, {.5, 2., 3.3, 6.}, "Eps");
+
+    AsOfJoinOptions options;
+    auto st_aj = AsOfJoin(left, right, options);
+    ASSERT_TRUE(st_aj.ok()) << "Error: " << st_aj.status();
+    auto joined = st_aj.ValueOrDie();
+    ASSERT_EQ(joined->num_columns(), 3);
+    ASSERT_EQ(joined->num_rows(), 5);
+    expect_values(values(joined, "Eps"), {.5, 2., 2., 3.3, 3.3});
+
+    options.allow_exact_matches = false;
+    auto st_aa = AsOfAlign(left, right, options);
+    ASSERT_TRUE(st_aa.ok()) << "Error: " << st_aa.status();
+    expect_values(values(st_aa.ValueOrDie(), "Eps"), {.5, .5, 2., 3.3, 3.3});
+
+    options.allow_exact_matches = true;
+    options.tolerance = std::chrono::nanoseconds(5);
+    st_aa = AsOfAlign(left, right, options);
+    ASSERT_TRUE(st_aa.ok()) << "Error: " << st_aa.status();
+    expect_values(values(st_aa.ValueOrDie(), "Eps"), {.5, 2., nan, nan, nan});
+
+    options.direction = AsOfDirection::FORWARD;
+    options.tolerance = std::nullopt;
+    st_aa = AsOfAlign(left, right, options);
+    ASSERT_TRUE(st_aa.ok()) << "Error: " << st_aa.status();
+    expect_values(values(st_aa.ValueOrDie(), "Eps"), {2., 2., 3.3, 6., 6.});
+
+    // unsorted dates are rejected
+    auto unsorted = dated_table({20, 10}, {1, 2}, "Eps");
+    ASSERT_FALSE(AsOfAlign(left, unsorted).ok());
+}
+
+TEST(JoinTest, AsOfAlignedIsZeroCopy) {
+    auto left = dated_table({10, 20, 30}, {1, 2, 3}, "Close");
+    auto right = dated_table({0, 10, 20, 30, 40}, {0, 1, 2, 3, 4}, "Eps");
+
+    auto st_aa = AsOfAlign(left, right);
+    ASSERT_TRUE(st_aa.ok()) << "Error: " << st_aa.status();
+    auto aligned = st_aa.ValueOrDie();
+    expect_values(values(aligned, "Eps"), {1, 2, 3});
+
+    // a slice of right's buffers, not a copy
+    auto &src = right->GetColumnByName("Eps")->chunk(0)->data();
+    auto &dst = aligned->GetColumnByName("Eps")->chunk(0)->data();
+    ASSERT_EQ(dst->buffers[1], src->buffers[1]);
+    ASSERT_EQ(dst->offset, 1);
+}
+
+TEST(JoinTest, ExtendTableAsOf) {
+    auto left = dated_table({10, 20, 30}, {1, 2, 3}, "Close");
+    auto right = dated_table({15}, {1.5}, "Eps");
+
+    auto st_et = ExtendTable(left, right, AsOfJoinOptions{});
+    ASSERT_TRUE(st_et.ok()) << "Error: " << st_et.status();
+    auto extended = st_et.ValueOrDie();
+    ASSERT_EQ(extended->ColumnNames(),
+              (vector<string>{"Date", "Close", "Eps"}));
+    expect_values(values(extended, "Eps"), {std::nan(""), 1.5, 1.5});
+
+    // positional by default, even with dates, so the rows must line up
+    ASSERT_FALSE(ExtendTable(left, right).ok());
+}
+
+TEST(JoinTest, ExtendTableNullDates) {
+    // positional extension ignores the dates, nulls included
+    arrow::TimestampBuilder date_builder(
+        arrow::timestamp(arrow::TimeUnit::NANO), arrow::default_memory_pool());
+    ASSERT_TRUE(date_builder.AppendValues({10, 20}).ok());
+    ASSERT_TRUE(date_builder.AppendNull().ok());
+    auto left = arrow::Table::Make(
+        arrow::schema({arrow::field("Date", date_builder.type())}),
+        {date_builder.Finish().ValueOrDie()});
+    auto right = dated_table({10, 20, 30}, {1, 2, 3}, "Eps");
+
+    auto st_et = ExtendTable(left, right->RemoveColumn(0).ValueOrDie());
+    ASSERT_TRUE(st_et.ok()) << "Error: " << st_et.status();
+    expect_values(values(st_et.ValueOrDie(), "Eps"), {1, 2, 3});
+
+    ASSERT_FALSE(ExtendTable(left, right, AsOfJoinOptions{}).ok());
+}
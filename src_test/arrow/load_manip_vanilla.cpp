@@ -2,23 +2,31 @@
 #include <arrow/array/data.h>
 #include <arrow/compute/api.h>
 #include <arrow/io/api.h>
+#include <arrow/ipc/feather.h>
 #include <arrow/stl_iterator.h>
 #include <arrow/table.h>
 #include <gtest/gtest.h>
 #include <parquet/arrow/reader.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <filesystem>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "YABTE/BackTest/common.hpp"
 #include "YABTE/Utilities/Arrow/TableHelpers.hpp"
 #include "data/test_data.h"
 
 using std::shared_ptr, std::vector, std::as_const;
 
-using YABTE::Utilities::Arrow::LoadTable, YABTE::Utilities::Arrow::ReadToTable,
+using YABTE::Utilities::Arrow::LoadTable, YABTE::Utilities::Arrow::LoadOptions,
+    YABTE::Utilities::Arrow::ReadToTable,
     YABTE::Utilities::Arrow::ExtendTable,
     YABTE::Utilities::Arrow::HorizConcatTables;
 
@@ -57,6 +65,150 @@ TEST(ArrowTest, LoadTable) {
     }
 }
 
+TEST(ArrowTest, LoadTableWithOptions) {
+    auto test_data_dir = fs::weakly_canonical(test_data_path());
+    auto np = (test_data_dir / "data_sample.parquet").string();
+
+    auto st_full = LoadTable(np);
+    ASSERT_TRUE(st_full.ok()) << "Error: " << st_full.status();
+    auto full = st_full.ValueOrDie();
+    ASSERT_GT(full->num_rows(), 30);
+
+    // dates are nanosecond timestamps as the runner expects
+    auto date_at = [&](int64_t i) {
+        auto scalar = full->GetColumnByName("Date")->GetScalar(i).ValueOrDie();
+        return timestamp_from_ns(
+            std::static_pointer_cast<arrow::TimestampScalar>(scalar)->value);
+    };
+
+    LoadOptions options;
+    options.memory_map = true;
+    options.use_threads = true;
+    options.assets = {"GOOG"};
+    options.fields = {"Close", "Open"};
+    options.start = date_at(10);
+    options.end = date_at(30);
+
+    auto st_lt = LoadTable(np, options);
+    ASSERT_TRUE(st_lt.ok()) << "Error: " << st_lt.status();
+    auto table = st_lt.ValueOrDie();
+
+    vector<string> names{"('GOOG', 'Open')", "('GOOG', 'Close')", "Date"};
+    for (auto &name : table->ColumnNames())
+        ASSERT_NE(std::find(names.begin(), names.end(), name), names.end())
+            << name;
+    ASSERT_EQ(table->num_columns(), 3);
+
+    auto expected = full->Slice(10, 20);
+    ASSERT_EQ(table->num_rows(), 20);
+    for (auto &name : names) {
+        ASSERT_TRUE(table->GetColumnByName(name)->Equals(
+            expected->GetColumnByName(name)))
+            << name;
+    }
+
+    // a range past the data skips every row group
+    options.start = date_at(full->num_rows() - 1) + std::chrono::hours(24);
+    options.end = std::nullopt;
+    auto st_empty = LoadTable(np, options);
+    ASSERT_TRUE(st_empty.ok()) << "Error: " << st_empty.status();
+    ASSERT_EQ(st_empty.ValueOrDie()->num_rows(), 0);
+    ASSERT_EQ(st_empty.ValueOrDie()->num_columns(), 3);
+}
+
+TEST(ArrowTest, LoadOrcAndIpcTables) {
+    auto test_data_dir = fs::weakly_canonical(test_data_path());
+    auto st_pq = LoadTable((test_data_dir / "data_sample.parquet").string());
+    ASSERT_TRUE(st_pq.ok()) << "Error: " << st_pq.status();
+    auto parquet_table = st_pq.ValueOrDie();
+    auto close = parquet_table->GetColumnByName("('GOOG', 'Close')");
+
+    LoadOptions options;
+    options.assets = {"GOOG"};
+    options.fields = {"Close"};
+
+    auto st_orc =
+        LoadTable((test_data_dir / "data_sample.orc").string(), options);
+    ASSERT_TRUE(st_orc.ok()) << "Error: " << st_orc.status();
+    auto orc_table = st_orc.ValueOrDie();
+    ASSERT_EQ(orc_table->num_rows(), parquet_table->num_rows());
+    ASSERT_TRUE(orc_table->GetColumnByName("('GOOG', 'Close')")->Equals(close));
+
+    // round trip through feather v2
+    auto fp = fs::temp_directory_path() /
+              ("yabte_load_" + std::to_string(getpid()) + ".feather");
+    {
+        auto st_out = arrow::io::FileOutputStream::Open(fp.string());
+        ASSERT_TRUE(st_out.ok()) << "Error: " << st_out.status();
+        ASSERT_TRUE(arrow::ipc::feather::WriteTable(*parquet_table,
+                                                    st_out.ValueOrDie().get())
+                        .ok());
+    }
+    options.memory_map = true;
+    auto st_ipc = LoadTable(fp.string(), options);
+    fs::remove(fp);
+    ASSERT_TRUE(st_ipc.ok()) << "Error: " << st_ipc.status();
+    auto ipc_table = st_ipc.ValueOrDie();
+    ASSERT_EQ(ipc_table->num_columns(), 2);
+    ASSERT_TRUE(ipc_table->GetColumnByName("('GOOG', 'Close')")->Equals(close));
+}
+
+TEST(ArrowTest, LoadTableCache) {
+    auto test_data_dir = fs::weakly_canonical(test_data_path());
+    auto np = (test_data_dir / "data_sample.parquet").string();
+    auto cache_dir =
+        fs::temp_directory_path() / ("yabte_cache_" + std::to_string(getpid()));
+
+    LoadOptions options;
+    options.assets = {"GOOG", "META"};
+    options.cache_dir = cache_dir.string();
+
+    auto st_cold = LoadTable(np, options);
+    ASSERT_TRUE(st_cold.ok()) << "Error: " << st_cold.status();
+    ASSERT_EQ(std::distance(fs::directory_iterator(cache_dir),
+                            fs::directory_iterator()),
+              1);
+
+    auto st_warm = LoadTable(np, options);
+    ASSERT_TRUE(st_warm.ok()) << "Error: " << st_warm.status();
+    ASSERT_TRUE(st_warm.ValueOrDie()->Equals(*st_cold.ValueOrDie()));
+
+    // the same schema as an uncached load
+    auto uncached = options;
+    uncached.cache_dir = std::nullopt;
+    auto st_raw = LoadTable(np, uncached);
+    ASSERT_TRUE(st_raw.ok()) << "Error: " << st_raw.status();
+    ASSERT_TRUE(
+        st_raw.ValueOrDie()->schema()->Equals(*st_cold.ValueOrDie()->schema()));
+
+    // other options get their own entry
+    options.assets = {"GOOG"};
+    ASSERT_TRUE(LoadTable(np, options).ok());
+    auto num_files = [&]() {
+        return std::distance(fs::directory_iterator(cache_dir),
+                             fs::directory_iterator());
+    };
+    ASSERT_EQ(num_files(), 2);
+
+    // a changed source replaces its stale entries
+    auto copy = cache_dir / "source" / "data_sample.parquet";
+    fs::create_directories(copy.parent_path());
+    fs::copy_file(np, copy);
+    ASSERT_TRUE(LoadTable(copy.string(), options).ok());
+    ASSERT_EQ(num_files(), 4);
+    fs::last_write_time(copy,
+                        fs::last_write_time(copy) + std::chrono::seconds(10));
+    ASSERT_TRUE(LoadTable(copy.string(), options).ok());
+    ASSERT_EQ(num_files(), 4);
+
+    // a cache that can't be written still loads
+    options.cache_dir = (copy / "not_a_dir").string();
+    auto st_unwritable = LoadTable(np, options);
+    ASSERT_TRUE(st_unwritable.ok()) << "Error: " << st_unwritable.status();
+
+    fs::remove_all(cache_dir);
+}
+
 TEST(ArrowTest, ExtendTable) {
     auto read_options = arrow::json::ReadOptions::Defaults();
     auto parse_options = arrow::json::ParseOptions::Defaults();
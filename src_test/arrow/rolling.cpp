@@ -0,0 +1,276 @@
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "YABTE/Utilities/Arrow/ComputeFunctions.hpp"
+#include "YABTE/Utilities/Arrow/Rolling.hpp"
+#include "YABTE/Utilities/Arrow/TableHelpers.hpp"
+
+using std::shared_ptr, std::vector, std::optional;
+
+using YABTE::Utilities::Arrow::RollingSum, YABTE::Utilities::Arrow::RollingMean,
+    YABTE::Utilities::Arrow::RollingVar, YABTE::Utilities::Arrow::RollingStd,
+    YABTE::Utilities::Arrow::RollingMin, YABTE::Utilities::Arrow::RollingMax,
+    YABTE::Utilities::Arrow::RollingZScore,
+    YABTE::Utilities::Arrow::RollingRank, YABTE::Utilities::Arrow::Crossover,
+    YABTE::Utilities::Arrow::RegisterComputeFunctions,
+    YABTE::Utilities::Arrow::ExponentialMovingAverage,
+    YABTE::Utilities::Arrow::ComputeMovingAverage;
+
+namespace {
+
+// two chunks with a null in the second
+shared_ptr<arrow::ChunkedArray> sample_values() {
+    arrow::DoubleBuilder builder;
+    shared_ptr<arrow::Array> a, b;
+    EXPECT_TRUE(builder.AppendValues({3., 1., 4., 1., 5.}).ok());
+    EXPECT_TRUE(builder.Finish(&a).ok());
+    EXPECT_TRUE(builder.AppendValues({9., 2.}).ok());
+    EXPECT_TRUE(builder.AppendNull().ok());
+    EXPECT_TRUE(builder.AppendValues({6., 5., 3.}).ok());
+    EXPECT_TRUE(builder.Finish(&b).ok());
+    return std::make_shared<arrow::ChunkedArray>(arrow::ArrayVector{a, b});
+}
+
+template <typename Builder, typename T>
+shared_ptr<arrow::ChunkedArray> make_chunked(const vector<optional<T>> &xs) {
+    Builder builder;
+    for (auto const &x : xs)
+        EXPECT_TRUE((x ? builder.Append(*x) : builder.AppendNull()).ok());
+    return std::make_shared<arrow::ChunkedArray>(builder.Finish().ValueOrDie());
+}
+
+vector<optional<double>> to_vector(const shared_ptr<arrow::ChunkedArray> &ca) {
+    vector<optional<double>> out;
+    for (auto const &chunk : ca->chunks()) {
+        auto &arr = static_cast<const arrow::DoubleArray &>(*chunk);
+        for (int64_t i = 0; i < arr.length(); ++i)
+            out.push_back(arr.IsNull(i) ? std::nullopt
+                                        : optional<double>(arr.Value(i)));
+    }
+    return out;
+}
+
+// naive reference: apply f to the valid values of each trailing window
+template <typename F>
+vector<optional<double>> naive(const vector<optional<double>> &x, int64_t n,
+                               int64_t min_periods, F f) {
+    vector<optional<double>> out;
+    for (int64_t i = 0; i < static_cast<int64_t>(x.size()); ++i) {
+        vector<double> w;
+        for (int64_t j = std::max<int64_t>(0, i - n + 1); j <= i; ++j)
+            if (x[j]) w.push_back(*x[j]);
+        if (static_cast<int64_t>(w.size()) >= min_periods && !w.empty())
+            out.push_back(f(w));
+        else
+            out.push_back(std::nullopt);
+    }
+    return out;
+}
+
+void expect_near(const vector<optional<double>> &actual,
+                 const vector<optional<double>> &expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_EQ(actual[i].has_value(), expected[i].has_value()) << i;
+        if (actual[i]) EXPECT_NEAR(*actual[i], *expected[i], 1e-9) << i;
+    }
+}
+
+double mean(const vector<double> &w) {
+    double s = 0.;
+    for (auto v : w) s += v;
+    return s / w.size();
+}
+
+double var(const vector<double> &w) {
+    if (w.size() < 2) return std::nan("");
+    auto m = mean(w);
+    double s = 0.;
+    for (auto v : w) s += (v - m) * (v - m);
+    return s / (w.size() - 1);
+}
+
+}  // namespace
+
+TEST(RollingTest, SumMean) {
+    auto vals = sample_values();
+    auto x = to_vector(vals);
+
+    auto st_sum = RollingSum(vals, 3);
+    ASSERT_TRUE(st_sum.ok()) << st_sum.status();
+    expect_near(to_vector(*st_sum), naive(x, 3, 3, [](auto &w) {
+                    return mean(w) * w.size();
+                }));
+
+    auto st_mean = RollingMean(vals, 3, 2);
+    ASSERT_TRUE(st_mean.ok()) << st_mean.status();
+    ASSERT_EQ((*st_mean)->num_chunks(), 1);
+    expect_near(to_vector(*st_mean), naive(x, 3, 2, mean));
+
+    ASSERT_FALSE(RollingMean(vals, 0).ok());
+    ASSERT_FALSE(RollingMean(vals, 3, 4).ok());
+}
+
+TEST(RollingTest, VarStdZScore) {
+    auto vals = sample_values();
+    auto x = to_vector(vals);
+
+    auto st_var = RollingVar(vals, 4);
+    ASSERT_TRUE(st_var.ok()) << st_var.status();
+    expect_near(to_vector(*st_var), naive(x, 4, 4, var));
+
+    auto st_std = RollingStd(vals, 4, 2);
+    ASSERT_TRUE(st_std.ok()) << st_std.status();
+    expect_near(to_vector(*st_std), naive(x, 4, 2, [](auto &w) {
+                    return std::sqrt(var(w));
+                }));
+
+    auto st_z = RollingZScore(vals, 4);
+    ASSERT_TRUE(st_z.ok()) << st_z.status();
+    auto z = to_vector(*st_z);
+    EXPECT_FALSE(z[2].has_value());
+    EXPECT_FALSE(z[7].has_value());
+    vector<double> w{3., 1., 4., 1.};
+    EXPECT_NEAR(*z[3], (1. - mean(w)) / std::sqrt(var(w)), 1e-9);
+}
+
+TEST(RollingTest, MinMax) {
+    auto vals = sample_values();
+    auto x = to_vector(vals);
+
+    auto st_min = RollingMin(vals, 3);
+    ASSERT_TRUE(st_min.ok()) << st_min.status();
+    expect_near(to_vector(*st_min), naive(x, 3, 3, [](auto &w) {
+                    return *std::min_element(w.begin(), w.end());
+                }));
+
+    auto st_max = RollingMax(vals, 4, 1);
+    ASSERT_TRUE(st_max.ok()) << st_max.status();
+    expect_near(to_vector(*st_max), naive(x, 4, 1, [](auto &w) {
+                    return *std::max_element(w.begin(), w.end());
+                }));
+}
+
+TEST(RollingTest, ExponentialMovingAverage) {
+    auto vals = sample_values();
+    auto x = to_vector(vals);
+
+    auto st_ema = ExponentialMovingAverage(vals, 3.);
+    ASSERT_TRUE(st_ema.ok()) << st_ema.status();
+    auto ema = to_vector(*st_ema);
+
+    double y = *x[0];
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (i > 0 && x[i]) y = 0.5 * y + 0.5 * *x[i];
+        ASSERT_TRUE(ema[i].has_value());
+        EXPECT_NEAR(*ema[i], y, 1e-9);
+    }
+}
+
+TEST(RollingTest, ComputeMovingAverage) {
+    auto vals = sample_values();
+    auto x = to_vector(vals);
+
+    auto st_cma = ComputeMovingAverage(vals, 3);
+    ASSERT_TRUE(st_cma.ok()) << st_cma.status();
+    auto ma = to_vector(*st_cma);
+
+    ASSERT_EQ(ma.size(), x.size());
+    // NaN rather than null before the first full window
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(ma[i].has_value());
+        EXPECT_TRUE(std::isnan(*ma[i]));
+    }
+    EXPECT_NEAR(*ma[3], (3. + 1. + 4.) / 3, 1e-9);
+    EXPECT_NEAR(*ma[7], (5. + 9. + 2.) / 3, 1e-9);
+    EXPECT_NEAR(*ma[8], (9. + 2.) / 2, 1e-9);
+}
+
+TEST(RollingTest, RankCrossover) {
+    auto vals = sample_values();
+    auto x = to_vector(vals);
+
+    auto average_rank = [](auto &w) {
+        double less = 0., equal = 0.;
+        for (auto v : w) {
+            less += v < w.back();
+            equal += v == w.back();
+        }
+        return less + (equal + 1.) / 2.;
+    };
+    for (auto min_periods : {2, 3}) {
+        auto st_rank = RollingRank(vals, 3, min_periods);
+        ASSERT_TRUE(st_rank.ok()) << st_rank.status();
+        auto expected = naive(x, 3, min_periods, average_rank);
+        for (size_t i = 0; i < x.size(); ++i)
+            if (!x[i]) expected[i] = std::nullopt;
+        expect_near(to_vector(*st_rank), expected);
+    }
+
+    // a crosses above a flat 3 twice, nulls block the middle
+    auto a = make_chunked<arrow::DoubleBuilder, double>({1., 4., 2., 1., 4.});
+    auto b = make_chunked<arrow::Int64Builder, int64_t>(
+        {3, 3, std::nullopt, 3, 3});
+    auto st_xo = Crossover(a, b);
+    ASSERT_TRUE(st_xo.ok()) << st_xo.status();
+    auto xo = (*st_xo)->chunk(0);
+    ASSERT_EQ(xo->type_id(), arrow::Type::BOOL);
+    EXPECT_EQ(xo->null_count(), 3);
+    auto &bools = static_cast<const arrow::BooleanArray &>(*xo);
+    EXPECT_TRUE(bools.IsNull(0));
+    EXPECT_TRUE(bools.Value(1));
+    EXPECT_TRUE(bools.IsNull(2));
+    EXPECT_TRUE(bools.IsNull(3));
+    EXPECT_TRUE(bools.Value(4));
+}
+
+TEST(RollingTest, ComputeFunctions) {
+    ASSERT_TRUE(RegisterComputeFunctions().ok());
+    // registering twice is fine
+    ASSERT_TRUE(RegisterComputeFunctions().ok());
+
+    auto vals = sample_values();
+
+    // chunked input
+    auto st_mean = arrow::compute::CallFunction(
+        "yabte_rolling_mean", {vals, arrow::Datum(int64_t(3))});
+    ASSERT_TRUE(st_mean.ok()) << st_mean.status();
+    auto expected = RollingMean(vals, 3).ValueOrDie();
+    ASSERT_TRUE(st_mean->chunked_array()->Equals(*expected));
+
+    // array input with optional parameters
+    auto combined = arrow::Concatenate(vals->chunks()).ValueOrDie();
+    auto st_std = arrow::compute::CallFunction(
+        "yabte_rolling_std", {combined, arrow::Datum(int64_t(4)),
+                              arrow::Datum(int64_t(2)), arrow::Datum(0)});
+    ASSERT_TRUE(st_std.ok()) << st_std.status();
+    ASSERT_TRUE(st_std->is_array());
+    auto expected_std = RollingStd(vals, 4, 2, 0).ValueOrDie();
+    ASSERT_TRUE(st_std->make_array()->Equals(*expected_std->chunk(0)));
+
+    auto st_ema = arrow::compute::CallFunction("yabte_ema",
+                                               {vals, arrow::Datum(3)});
+    ASSERT_TRUE(st_ema.ok()) << st_ema.status();
+
+    auto st_xo =
+        arrow::compute::CallFunction("yabte_crossover", {vals, combined});
+    ASSERT_TRUE(st_xo.ok()) << st_xo.status();
+    ASSERT_EQ(st_xo->length(), vals->length());
+
+    // bad parameters surface as errors
+    ASSERT_FALSE(arrow::compute::CallFunction("yabte_rolling_mean",
+                                              {vals, arrow::Datum(int64_t(0))})
+                     .ok());
+    ASSERT_FALSE(arrow::compute::CallFunction(
+                     "yabte_rolling_mean",
+                     {vals, arrow::Datum(int64_t(3)), arrow::Datum(int64_t(1)),
+                      arrow::Datum(int64_t(1))})
+                     .ok());
+}
@@ -0,0 +1,71 @@
+#include <arrow/api.h>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <memory>
+#include <vector>
+
+#include "YABTE/Utilities/Arrow/SharedMemory.hpp"
+
+using std::shared_ptr, std::vector;
+
+using YABTE::Utilities::Arrow::SharedTable;
+
+namespace {
+
+shared_ptr<arrow::Table> sample_table() {
+    arrow::Int64Builder ints;
+    EXPECT_TRUE(ints.AppendValues({1, 2, 3, 4}).ok());
+    arrow::DoubleBuilder doubles;
+    EXPECT_TRUE(doubles.AppendValues({.5, 1.5, 2.5, 3.5}).ok());
+    EXPECT_TRUE(doubles.AppendNull().ok());
+    EXPECT_TRUE(ints.AppendNull().ok());
+
+    auto schema = arrow::schema({arrow::field("i", arrow::int64()),
+                                 arrow::field("x", arrow::float64())});
+    return arrow::Table::Make(
+        schema, {ints.Finish().ValueOrDie(), doubles.Finish().ValueOrDie()});
+}
+
+}  // namespace
+
+TEST(SharedMemoryTest, PublishMap) {
+    auto table = sample_table();
+    auto st_shared = SharedTable::Publish(table);
+    ASSERT_TRUE(st_shared.ok()) << st_shared.status();
+    auto shared = st_shared.ValueOrDie();
+    ASSERT_GT(shared->size(), 0);
+
+    // names are unique, a second publish under the same name fails
+    auto st_again = SharedTable::Publish(table, shared->name());
+    ASSERT_FALSE(st_again.ok());
+
+    auto st_mapped = SharedTable::Map(shared->name());
+    ASSERT_TRUE(st_mapped.ok()) << st_mapped.status();
+    auto mapped = st_mapped.ValueOrDie();
+    ASSERT_TRUE(mapped->Equals(*table));
+
+    // the mapping outlives the unlinked name
+    auto name = shared->name();
+    shared.reset();
+    ASSERT_FALSE(SharedTable::Map(name).ok());
+    ASSERT_TRUE(mapped->Equals(*table));
+}
+
+TEST(SharedMemoryTest, MapInChild) {
+    auto table = sample_table();
+    auto shared = SharedTable::Publish(table).ValueOrDie();
+
+    auto pid = fork();
+    if (pid == 0) {
+        auto st_mapped = SharedTable::Map(shared->name());
+        _exit(st_mapped.ok() && st_mapped.ValueOrDie()->Equals(*table) ? 0
+                                                                         : 1);
+    }
+    ASSERT_GT(pid, 0);
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+#include "YABTE/Utilities/Concurrency/Executor.hpp"
+
+using std::vector;
+
+using YABTE::Utilities::Concurrency::Executor,
+    YABTE::Utilities::Concurrency::ExecutorOptions,
+    YABTE::Utilities::Concurrency::WorkerLocal;
+
+TEST(ExecutorTest, SubmitAndParallelFor) {
+    Executor executor({.num_threads = 3});
+    ASSERT_EQ(executor.num_threads(), 3u);
+    ASSERT_EQ(executor.worker_index(), -1);
+
+    auto future = executor.submit([&executor] {
+        return executor.worker_index();
+    });
+    auto index = future.get();
+    ASSERT_GE(index, 0);
+    ASSERT_LT(index, 3);
+
+    vector<int> seen(1000, 0);
+    executor.parallel_for(0, seen.size(), [&](int64_t i) { ++seen[i]; });
+    for (auto count : seen) ASSERT_EQ(count, 1);
+}
+
+TEST(ExecutorTest, ParallelForLimitsParallelism) {
+    Executor executor({.num_threads = 4});
+    std::atomic<int> running = 0, most = 0;
+    executor.parallel_for(
+        0, 200,
+        [&](int64_t) {
+            auto now = ++running;
+            for (auto m = most.load(); now > m;)
+                most.compare_exchange_weak(m, now);
+            --running;
+        },
+        2);
+    ASSERT_LE(most.load(), 2);
+}
+
+TEST(ExecutorTest, NestedParallelForDoesNotDeadlock) {
+    Executor executor({.num_threads = 2});
+    std::atomic<int> total = 0;
+    executor.parallel_for(0, 8, [&](int64_t) {
+        executor.parallel_for(0, 8, [&](int64_t) { ++total; });
+    });
+    ASSERT_EQ(total.load(), 64);
+}
+
+TEST(ExecutorTest, ParallelForRethrows) {
+    Executor executor({.num_threads = 2});
+    ASSERT_THROW(executor.parallel_for(0, 100,
+                                       [](int64_t i) {
+                                           if (i == 42)
+                                               throw std::runtime_error("42");
+                                       }),
+                 std::runtime_error);
+}
+
+TEST(ExecutorTest, WorkerLocal) {
+    Executor executor({.num_threads = 2});
+    WorkerLocal<std::pmr::unsynchronized_pool_resource> pools(executor);
+    ASSERT_THROW(pools.local(), std::logic_error);
+
+    // each worker's pool is only used by that worker
+    executor.parallel_for(0, 100, [&](int64_t) {
+        std::pmr::vector<int> values(100, &pools.local());
+    });
+}
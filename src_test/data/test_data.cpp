@@ -1,6 +1,15 @@
+#include "data/test_data.h"
+
+#include <glog/logging.h>
+
+#include <filesystem>
 #include <stdexcept>
 #include <string>
 
+#include "YABTE/Utilities/Arrow/TableHelpers.hpp"
+
+namespace fs = std::filesystem;
+
 std::string test_data_path() {
     auto test_data_dir = std::getenv("YABTE_CPP_TEST_DATA_DIR");
     if (test_data_dir != nullptr)
@@ -8,4 +17,13 @@ std::string test_data_path() {
     else
         return "/home/blair/projects/yabte_cpp/src_test/data";
     throw std::runtime_error("YABTE_CPP_TEST_DATA_DIR not set");
-}
\ No newline at end of file
+}
+
+std::shared_ptr<arrow::Table> sample_table() {
+    auto test_data_dir = fs::weakly_canonical(test_data_path());
+    auto np = test_data_dir / "data_sample.parquet";
+
+    auto st_lt = YABTE::Utilities::Arrow::LoadTable(np.string());
+    CHECK(st_lt.ok()) << "Error: " << st_lt.status();
+    return st_lt.ValueOrDie();
+}
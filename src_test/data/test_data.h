@@ -1,5 +1,11 @@
 #pragma once
 
+#include <arrow/table.h>
+
+#include <memory>
 #include <string>
 
-std::string test_data_path();
\ No newline at end of file
+std::string test_data_path();
+
+// data_sample.parquet of the test data
+std::shared_ptr<arrow::Table> sample_table();
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include <arrow/api.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "YABTE/BackTest/Analytics.hpp"
+#include "YABTE/BackTest/Book.hpp"
+
+using namespace YABTE::BackTest;
+
+using std::vector;
+
+namespace {
+
+const vector<double> sample_total{100., 110., 99., 105., 120., 118.};
+const vector<double> sample_mtm{0., 10., 20., 0., 60., 59.};
+
+// straightforward versions of the annualised ratios
+void expected_ratios(double &sharpe, double &sortino) {
+    vector<double> r;
+    for (size_t i = 1; i < sample_total.size(); ++i)
+        r.push_back(sample_total[i] / sample_total[i - 1] - 1);
+    double mean = 0., var = 0., down = 0.;
+    for (auto x : r) mean += x / r.size();
+    for (auto x : r) {
+        var += (x - mean) * (x - mean) / (r.size() - 1);
+        down += std::pow(std::min(x, 0.), 2) / r.size();
+    }
+    sharpe = mean / std::sqrt(var) * std::sqrt(252.);
+    sortino = mean / std::sqrt(down) * std::sqrt(252.);
+}
+
+}  // namespace
+
+TEST(AnalyticsTest, ComputePerformance) {
+    auto s = ComputePerformance(sample_total.data(), sample_mtm.data(),
+                                sample_total.size(), 500.);
+
+    EXPECT_EQ(s.num_days, 6);
+    EXPECT_DOUBLE_EQ(s.total_return, 0.18);
+    EXPECT_DOUBLE_EQ(s.annual_return, std::pow(1.18, 252. / 5) - 1);
+    EXPECT_DOUBLE_EQ(s.max_drawdown, 11. / 110.);
+    EXPECT_EQ(s.max_drawdown_duration, 2);
+    EXPECT_DOUBLE_EQ(s.calmar_ratio, s.annual_return / s.max_drawdown);
+
+    double sharpe, sortino;
+    expected_ratios(sharpe, sortino);
+    EXPECT_NEAR(s.sharpe_ratio, sharpe, 1e-12);
+    EXPECT_NEAR(s.sortino_ratio, sortino, 1e-12);
+
+    double mean_total = 0., exposure = 0.;
+    for (size_t i = 0; i < sample_total.size(); ++i) {
+        mean_total += sample_total[i] / sample_total.size();
+        exposure += sample_mtm[i] / sample_total[i] / sample_total.size();
+    }
+    EXPECT_NEAR(s.turnover, 500. / mean_total, 1e-12);
+    EXPECT_NEAR(s.exposure, exposure, 1e-12);
+}
+
+TEST(AnalyticsTest, ComputePerformanceShortHistory) {
+    auto s = ComputePerformance(nullptr, nullptr, 0);
+    EXPECT_EQ(s.num_days, 0);
+    EXPECT_TRUE(std::isnan(s.sharpe_ratio));
+    EXPECT_EQ(s.max_drawdown, 0.);
+
+    double total = 100.;
+    s = ComputePerformance(&total, nullptr, 1);
+    EXPECT_TRUE(std::isnan(s.total_return));
+    EXPECT_TRUE(std::isnan(s.exposure));
+    EXPECT_DOUBLE_EQ(s.turnover, 0.);
+}
+
+TEST(AnalyticsTest, BookHistory) {
+    Book book("bk1", "USD");
+    for (size_t i = 0; i < sample_total.size(); ++i) {
+        auto mtm = sample_mtm[i];
+        book._history_.push_back({timestamp_from_ns(i * 86400000000000),
+                                  sample_total[i] - mtm, mtm,
+                                  sample_total[i]});
+    }
+    book.ledger_.append_trade(timestamp_from_ns(0),
+                              book.symbols_->intern("GOOG"), -5., 100., "");
+
+    auto from_book = ComputePerformance(book);
+    auto st_ps = ComputePerformance(book.history(), 500.);
+    ASSERT_TRUE(st_ps.ok()) << "Error: " << st_ps.status();
+    auto from_table = *st_ps;
+
+    EXPECT_DOUBLE_EQ(from_book.sharpe_ratio, from_table.sharpe_ratio);
+    EXPECT_DOUBLE_EQ(from_book.exposure, from_table.exposure);
+    EXPECT_DOUBLE_EQ(from_book.turnover, from_table.turnover);
+
+    auto table = PerformanceTable(BookVector{book.clone(), book.clone()});
+    EXPECT_EQ(table->num_rows(), 2);
+    EXPECT_EQ(table->num_columns(), 12);
+    EXPECT_EQ(table->field(0)->name(), "book");
+    EXPECT_EQ(table->GetColumnByName("max_drawdown_duration")->type()->id(),
+              arrow::Type::INT64);
+
+    // on a caller's executor
+    YABTE::Utilities::Concurrency::Executor executor({.num_threads = 2});
+    auto on_executor =
+        PerformanceTable(BookVector{book.clone(), book.clone()}, 252.,
+                         executor);
+    ASSERT_EQ(on_executor->num_rows(), 2);
+    EXPECT_TRUE(on_executor->GetColumnByName("max_drawdown_duration")
+                    ->Equals(table->GetColumnByName("max_drawdown_duration")));
+}
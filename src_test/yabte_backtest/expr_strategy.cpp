@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "YABTE/BackTest/ExprStrategy.hpp"
+
+using std::string;
+
+using namespace YABTE::BackTest;
+
+using Kind = ExprNode::Kind;
+
+TEST(ExprStrategyTest, ParseRules) {
+    auto rules = ParseExprRules(
+        "# moving average crossover\n"
+        "cross(sma(Close, n), sma(Close, m)) -> buy 100\n"
+        "cross(sma(Close, m),\n"
+        "      sma(Close, n)) -> sell 2 * 50; Close > 1 and not Close > 2 "
+        "-> buy -x\n");
+    ASSERT_EQ(rules.size(), 3);
+
+    auto &buy = rules[0];
+    ASSERT_TRUE(buy.buy);
+    ASSERT_EQ(buy.condition->kind, Kind::CALL);
+    ASSERT_EQ(buy.condition->name, "cross");
+    ASSERT_EQ(buy.condition->args.size(), 2);
+    auto &sma = *buy.condition->args[0];
+    ASSERT_EQ(sma.name, "sma");
+    ASSERT_EQ(sma.args[0]->kind, Kind::NAME);
+    ASSERT_EQ(sma.args[0]->name, "Close");
+    ASSERT_EQ(buy.size->kind, Kind::NUMBER);
+    ASSERT_EQ(buy.size->number, 100.);
+
+    ASSERT_FALSE(rules[1].buy);
+    ASSERT_EQ(rules[1].size->kind, Kind::BINARY);
+    ASSERT_EQ(rules[1].size->name, "*");
+
+    // and binds looser than not, which binds looser than comparisons
+    auto &cond = *rules[2].condition;
+    ASSERT_EQ(cond.name, "and");
+    ASSERT_EQ(cond.args[0]->name, ">");
+    ASSERT_EQ(cond.args[1]->kind, Kind::UNARY);
+    ASSERT_EQ(cond.args[1]->name, "not");
+    ASSERT_EQ(cond.args[1]->args[0]->name, ">");
+    ASSERT_EQ(rules[2].size->kind, Kind::UNARY);
+    ASSERT_EQ(rules[2].size->name, "-");
+}
+
+TEST(ExprStrategyTest, Precedence) {
+    auto rules = ParseExprRules("a + b * c - d < e -> buy 1");
+    ASSERT_EQ(rules.size(), 1);
+    auto &cond = *rules[0].condition;
+    ASSERT_EQ(cond.name, "<");
+    auto &lhs = *cond.args[0];
+    ASSERT_EQ(lhs.name, "-");
+    ASSERT_EQ(lhs.args[0]->name, "+");
+    ASSERT_EQ(lhs.args[0]->args[1]->name, "*");
+
+    rules = ParseExprRules("(a + b) * c -> buy 1");
+    ASSERT_EQ(rules[0].condition->name, "*");
+    ASSERT_EQ(rules[0].condition->args[0]->name, "+");
+}
+
+TEST(ExprStrategyTest, SyntaxErrors) {
+    for (string source :
+         {"Close > 1", "Close > 1 -> hold 1", "sma(Close, 2 -> buy 1",
+          "Close $ 1 -> buy 1", "Close > -> buy 1", "Close > 1 -> buy 1 2",
+          "-> buy 1"}) {
+        ASSERT_THROW(ParseExprRules(source), std::invalid_argument) << source;
+    }
+    ASSERT_TRUE(ParseExprRules("").empty());
+    ASSERT_TRUE(ParseExprRules("\n# nothing\n;").empty());
+
+    try {
+        ParseExprRules("Close > 1 -> buy (1");
+        FAIL();
+    } catch (const std::invalid_argument &e) {
+        ASSERT_NE(string(e.what()).find("at 19"), string::npos) << e.what();
+    }
+}
+
+TEST(ExprStrategyTest, Lookback) {
+    ExprStrategy strategy(
+        "cross(lag(sma(Close, n), 1), lag(sma(Close, m), 1)) -> buy 100",
+        "GOOG");
+    strategy.params_ = {{"n", 10}, {"m", 20}};
+    ASSERT_EQ(strategy.lookback(), 21);
+
+    strategy.params_ = {{"n", 10}};
+    ASSERT_THROW(strategy.lookback(), std::invalid_argument);
+}
@@ -1,9 +1,33 @@
+#include <arrow/util/bit_util.h>
 #include <gtest/gtest.h>
 
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "YABTE/BackTest/Arena.hpp"
 #include "YABTE/BackTest/Asset.hpp"
+#include "YABTE/BackTest/Book.hpp"
+#include "YABTE/BackTest/ColumnPlan.hpp"
+#include "YABTE/BackTest/IndicatorCache.hpp"
+#include "YABTE/BackTest/Ledger.hpp"
+#include "YABTE/BackTest/Order.hpp"
+#include "YABTE/BackTest/SymbolTable.hpp"
+#include "YABTE/BackTest/TableView.hpp"
 #include "YABTE/BackTest/Transaction.hpp"
+#include "YABTE/Utilities/Arrow/TableHelpers.hpp"
+
+using YABTE::BackTest::OHLCAsset, YABTE::BackTest::Trade,
+    YABTE::BackTest::Book, YABTE::BackTest::ColumnPlan,
+    YABTE::BackTest::TableView, YABTE::BackTest::DayView,
+    YABTE::BackTest::DataWindow, YABTE::BackTest::IndicatorCache,
+    YABTE::BackTest::Ledger, YABTE::BackTest::SymbolTable,
+    YABTE::BackTest::TransactionKind, YABTE::BackTest::RunArena,
+    YABTE::BackTest::ArenaScope, YABTE::BackTest::make_run_shared,
+    YABTE::BackTest::AssetMap, YABTE::BackTest::SimpleOrder,
+    YABTE::BackTest::OrderStatus;
 
-using YABTE::BackTest::OHLCAsset, YABTE::BackTest::Trade;
+using YABTE::Utilities::Arrow::ParseColumnName;
 
 TEST(TransactionTest, BasicAssertions) {
     auto ts = timestamp_from_ns(0);
@@ -11,6 +35,87 @@ TEST(TransactionTest, BasicAssertions) {
     EXPECT_NEAR(t.total_, -1000., 0.0001);
 }
 
+TEST(LedgerTest, BasicAssertions) {
+    SymbolTable symbols({"AMZN", "GOOG"});
+    EXPECT_EQ(symbols.id("GOOG"), 1);
+    EXPECT_EQ(symbols.intern("META"), 2);
+
+    // spans two chunks
+    Ledger ledger;
+    auto n = Ledger::kChunkRows + 10;
+    for (int64_t i = 0; i < n; ++i) {
+        if (i % 2 == 0)
+            ledger.append_trade(timestamp_from_ns(i), i % 3, 1. + i, 10.,
+                                "order");
+        else
+            ledger.append_cash(timestamp_from_ns(i), 5., "interest");
+    }
+    ASSERT_EQ(ledger.size(), n);
+    EXPECT_EQ(ledger.num_trades(), (n + 1) / 2);
+    EXPECT_EQ(ledger.kind(4), TransactionKind::TRADE);
+    EXPECT_EQ(ledger.total(4), -50.);
+    EXPECT_EQ(ledger.asset_id(5), YABTE::BackTest::NO_ASSET_ID);
+
+    auto t = ledger.transaction(2, symbols);
+    auto trade = std::dynamic_pointer_cast<Trade>(t);
+    ASSERT_TRUE(trade);
+    EXPECT_EQ(trade->asset_name_, "META");
+    EXPECT_EQ(trade->desc_, "buy META");
+    EXPECT_EQ(ledger.transaction(3, symbols)->desc_, "interest");
+
+    // the table shares the ledger's buffers
+    auto table = ledger.to_table(symbols);
+    ASSERT_EQ(table->num_rows(), n);
+    ASSERT_EQ(table->column(0)->num_chunks(), 2);
+    auto quantity = table->GetColumnByName("quantity")->chunk(1);
+    EXPECT_EQ(std::static_pointer_cast<arrow::DoubleArray>(quantity)->Value(0),
+              1. + Ledger::kChunkRows);
+
+    // copies don't see later appends
+    Ledger copy(ledger);
+    ledger.append_cash(timestamp_from_ns(n), 1., "late");
+    EXPECT_EQ(copy.size(), n);
+    copy.append_cash(timestamp_from_ns(n), 2., "other");
+    EXPECT_EQ(ledger.total(n), 1.);
+    EXPECT_EQ(copy.total(n), 2.);
+    EXPECT_EQ(table->num_rows(), n);
+
+    // the first chunk starts small and grows as it fills
+    Ledger small;
+    small.append_cash(timestamp_from_ns(0), 1., "a");
+    auto ts = small.to_table(symbols)->column(0)->chunk(0)->data();
+    EXPECT_EQ(ts->buffers[1]->size(),
+              Ledger::kFirstChunkRows * int64_t{sizeof(int64_t)});
+    Ledger small_copy(small);
+    EXPECT_EQ(small_copy.total(0), 1.);
+}
+
+TEST(RunArenaTest, BasicAssertions) {
+    auto ts = timestamp_from_ns(0);
+    EXPECT_FALSE(RunArena::current());
+
+    std::shared_ptr<Trade> trade;
+    std::weak_ptr<RunArena> weak;
+    {
+        auto arena = std::make_shared<RunArena>(1024);
+        weak = arena;
+        ArenaScope scope(arena);
+        EXPECT_EQ(RunArena::current(), arena);
+
+        trade = make_run_shared<Trade>(ts, 100., 10., "asset", "order");
+        auto stats = arena->stats();
+        EXPECT_EQ(stats.allocations, 1);
+        EXPECT_GE(stats.bytes, static_cast<int64_t>(sizeof(Trade)));
+    }
+    EXPECT_FALSE(RunArena::current());
+
+    // the trade keeps its arena alive
+    EXPECT_FALSE(weak.expired());
+    EXPECT_NEAR(trade->total_, -1000., 0.0001);
+    trade.reset();
+    EXPECT_TRUE(weak.expired());
+}
+
 TEST(AssetTest, BasicAssertions) {
     auto a = OHLCAsset("foo", "USD");
     EXPECT_EQ(a.name_, "foo");
@@ -20,3 +125,223 @@ TEST(AssetTest, BasicAssertions) {
     EXPECT_EQ(a.data_label_, a.name_);
     EXPECT_NEAR(a.round_quantity(1.2345), 1.23, 0.0001);
 }
+
+TEST(BookTest, BoundSymbols) {
+    auto ts = timestamp_from_ns(0);
+    Book book("bk", "USD", 1000.);
+    book.set_position("MSFT", 5.);
+    book._add_trade(Trade(ts, 1., 10., "AAPL", "order"));
+
+    // bound to a run's symbols, starting positions are kept
+    auto symbols = std::make_shared<SymbolTable>(
+        std::vector<std::string>{"AAPL", "GOOG"});
+    book._bind_symbols(symbols);
+    EXPECT_EQ(book.positions().at("MSFT"), 5.);
+    EXPECT_EQ(book.positions().at("AAPL"), 1.);
+    auto size = symbols->size();
+
+    // but trades in assets the run lacks are not interned
+    book._add_trade(Trade(ts, 2., 10., "GOOG", "order"));
+    EXPECT_EQ(book.positions().at("GOOG"), 2.);
+    EXPECT_THROW(book._add_trade(Trade(ts, 1., 10., "META", "order")),
+                 std::out_of_range);
+    EXPECT_EQ(symbols->size(), size);
+    EXPECT_EQ(book.cash_, 1000. - 30.);
+}
+
+namespace {
+// a SimpleOrder subclass counting the trades handed to post_complete
+class CountingOrder : public SimpleOrder {
+   public:
+    using SimpleOrder::SimpleOrder;
+
+    void post_complete(const vector<shared_ptr<Trade>> trades) override {
+        this->completed_ += trades.size();
+    }
+
+    size_t completed_ = 0;
+};
+}  // namespace
+
+TEST(OrderTest, PostComplete) {
+    arrow::DoubleBuilder builder;
+    shared_ptr<arrow::Array> close;
+    ASSERT_TRUE(builder.AppendValues({10.}).ok());
+    ASSERT_TRUE(builder.Finish(&close).ok());
+    auto schema =
+        arrow::schema({arrow::field("('GOOG', 'Close')", arrow::float64())});
+    auto table = arrow::Table::Make(schema, arrow::ArrayVector{close});
+    TableView view(table);
+
+    auto asset = std::make_shared<OHLCAsset>("GOOG", "USD");
+    asset->columns_ = asset->_resolve_columns(ColumnPlan(schema));
+    AssetMap asset_map(std::make_shared<SymbolTable>(
+        std::vector<std::string>{"GOOG"}));
+    asset_map.add(asset);
+
+    // a plain SimpleOrder and a subclass fill the same, only the subclass
+    // makes a Trade for its post_complete
+    auto ts = timestamp_from_ns(0);
+    auto counting = std::make_shared<CountingOrder>("GOOG", 2.);
+    for (shared_ptr<SimpleOrder> order :
+         {std::make_shared<SimpleOrder>("GOOG", 2.),
+          std::static_pointer_cast<SimpleOrder>(counting)}) {
+        auto book = std::make_shared<Book>("bk", "USD", 1000.);
+        book->_bind_symbols(asset_map.symbols_);
+        order->book_ = book;
+        order->apply(ts, DayView(view, 0), asset_map);
+        EXPECT_EQ(order->status_, OrderStatus::COMPLETE);
+        EXPECT_EQ(book->positions().at("GOOG"), 2.);
+        EXPECT_NEAR(book->cash_, 980., 0.0001);
+        EXPECT_EQ(book->ledger_.size(), 1);
+    }
+    EXPECT_EQ(counting->completed_, 1);
+}
+
+TEST(ColumnPlanTest, BasicAssertions) {
+    auto parsed = ParseColumnName("('GOOG', 'Close')");
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(std::get<0>(*parsed), "GOOG");
+    EXPECT_EQ(std::get<1>(*parsed), "Close");
+    EXPECT_FALSE(ParseColumnName("Date").has_value());
+    EXPECT_FALSE(ParseColumnName("('GO OG', 'Close')").has_value());
+
+    auto schema = arrow::schema(
+        {arrow::field("Date", arrow::timestamp(arrow::TimeUnit::NANO)),
+         arrow::field("('GOOG', 'High')", arrow::float64()),
+         arrow::field("('GOOG', 'Close')", arrow::float64()),
+         arrow::field("('MSFT', 'Close')", arrow::float64())});
+    ColumnPlan plan(schema);
+
+    auto a = OHLCAsset("GOOG", "USD");
+    auto columns = a._resolve_columns(plan);
+    ASSERT_EQ(columns.size(), 5);
+    EXPECT_EQ(columns[OHLCAsset::HIGH].index, 1);
+    EXPECT_FALSE(columns[OHLCAsset::LOW].resolved());
+    EXPECT_EQ(columns[OHLCAsset::CLOSE].index, 2);
+    EXPECT_EQ(columns[OHLCAsset::CLOSE].type, arrow::Type::DOUBLE);
+    EXPECT_EQ(columns.find("Close"), OHLCAsset::CLOSE);
+
+    auto b = OHLCAsset("AAPL", "USD");
+    EXPECT_THROW(b._resolve_columns(plan), std::runtime_error);
+}
+
+TEST(TableViewTest, BasicAssertions) {
+    arrow::DoubleBuilder builder;
+    shared_ptr<arrow::Array> close1, close2;
+    ASSERT_TRUE(builder.AppendValues({10., 11.}).ok());
+    ASSERT_TRUE(builder.Finish(&close1).ok());
+    ASSERT_TRUE(builder.AppendNull().ok());
+    ASSERT_TRUE(builder.Append(13.).ok());
+    ASSERT_TRUE(builder.Finish(&close2).ok());
+
+    auto schema =
+        arrow::schema({arrow::field("('GOOG', 'Close')", arrow::float64())});
+    auto table = arrow::Table::Make(
+        schema, {std::make_shared<arrow::ChunkedArray>(
+                    arrow::ArrayVector{close1, close2})});
+
+    TableView view(table);
+    ASSERT_EQ(view.num_rows(), 4);
+    ASSERT_EQ(view.column_index("('GOOG', 'Close')"), 0);
+
+    auto a = OHLCAsset("GOOG", "USD");
+    a.columns_ = a._resolve_columns(ColumnPlan(schema));
+
+    EXPECT_NEAR(a.end_of_day_price(DayView(view, 1)), 11., 0.0001);
+    EXPECT_FALSE(DayView(view, 2).is_valid(0));
+    EXPECT_TRUE(std::isnan(DayView(view, 2).value(0)));
+    EXPECT_NEAR(a.intraday_traded_price(DayView(view, 3)), 13., 0.0001);
+    EXPECT_EQ(DayView(view, 3).to_table()->num_rows(), 1);
+
+    DataWindow window(table);
+    auto close = window.column("('GOOG', 'Close')");
+    EXPECT_EQ(window.size(), 0);
+    EXPECT_THROW(close.last(), std::out_of_range);
+    window.advance();
+    window.advance();
+    EXPECT_NEAR(close.last(), 11., 0.0001);
+    EXPECT_NEAR(close.last(1), 10., 0.0001);
+    EXPECT_NEAR(close.at(0), 10., 0.0001);
+    EXPECT_THROW(close.at(2), std::out_of_range);
+    window.advance_to(4);
+    EXPECT_TRUE(std::isnan(close.last(1)));
+    EXPECT_FALSE(close.is_valid(-2));
+    EXPECT_NEAR(close.last(), 13., 0.0001);
+    EXPECT_EQ(window.table()->num_rows(), 4);
+    EXPECT_THROW(window.advance(), std::out_of_range);
+}
+
+TEST(IndicatorCacheTest, BasicAssertions) {
+    arrow::DoubleBuilder builder;
+    ASSERT_TRUE(builder.AppendValues({1., 2., 3., 4.}).ok());
+    auto values = std::make_shared<arrow::ChunkedArray>(
+        builder.Finish().ValueOrDie());
+
+    IndicatorCache cache;
+    std::atomic<int> calls = 0;
+    auto compute = [&]() -> arrow::Result<shared_ptr<arrow::ChunkedArray>> {
+        ++calls;
+        return values;
+    };
+
+    // concurrent requests for one key compute it once
+    std::vector<std::future<bool>> futures;
+    for (int i = 0; i < 8; ++i) {
+        futures.push_back(std::async(std::launch::async, [&]() {
+            auto st = cache.get_or_compute(values, "copy", {2}, compute);
+            return st.ok() && st.ValueOrDie() == values;
+        }));
+    }
+    for (auto& f : futures) EXPECT_TRUE(f.get());
+    EXPECT_EQ(calls, 1);
+
+    // params and slices of the source are part of the key
+    ASSERT_TRUE(cache.get_or_compute(values, "copy", {3}, compute).ok());
+    ASSERT_TRUE(
+        cache.get_or_compute(values->Slice(1), "copy", {2}, compute).ok());
+    EXPECT_EQ(calls, 3);
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 7);
+    EXPECT_EQ(stats.misses, 3);
+    EXPECT_EQ(stats.entries, 3);
+
+    // failures are not cached
+    auto fail = []() -> arrow::Result<shared_ptr<arrow::ChunkedArray>> {
+        return arrow::Status::Invalid("boom");
+    };
+    EXPECT_FALSE(cache.get_or_compute(values, "fail", {}, fail).ok());
+    EXPECT_EQ(cache.stats().entries, 3);
+    auto raise = []() -> arrow::Result<shared_ptr<arrow::ChunkedArray>> {
+        throw std::runtime_error("boom");
+    };
+    EXPECT_THROW(cache.get_or_compute(values, "raise", {}, raise),
+                 std::runtime_error);
+    EXPECT_EQ(cache.stats().entries, 3);
+    ASSERT_TRUE(cache.get_or_compute(values, "raise", {}, compute).ok());
+    EXPECT_EQ(calls, 4);
+
+    // the same values buffer with a null is another source
+    auto data = values->chunk(0)->data();
+    auto bitmap = arrow::AllocateEmptyBitmap(4).ValueOrDie();
+    arrow::bit_util::SetBitsTo(bitmap->mutable_data(), 0, 3, true);
+    auto with_null = std::make_shared<arrow::ChunkedArray>(
+        arrow::MakeArray(arrow::ArrayData::Make(
+            arrow::float64(), 4,
+            {shared_ptr<arrow::Buffer>(std::move(bitmap)), data->buffers[1]},
+            1)));
+    ASSERT_TRUE(cache.get_or_compute(with_null, "copy", {2}, compute).ok());
+    EXPECT_EQ(calls, 5);
+    EXPECT_EQ(cache.stats().entries, 5);
+
+    // registered arrow compute functions
+    auto st_mean = cache.compute(values, "yabte_rolling_mean", {2});
+    ASSERT_TRUE(st_mean.ok()) << st_mean.status();
+    EXPECT_EQ((*st_mean)->length(), 4);
+    ASSERT_TRUE(cache.compute(values, "yabte_rolling_mean", {2}).ok());
+    EXPECT_EQ(cache.stats().hits, 8);
+
+    cache.clear();
+    EXPECT_EQ(cache.stats().entries, 0);
+}
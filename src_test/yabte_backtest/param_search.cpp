@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "YABTE/BackTest/ParamSearch.hpp"
+
+using std::vector, std::string;
+
+using namespace YABTE::BackTest;
+
+TEST(ParamSearchTest, LatinHypercubeCoversEachStratum) {
+    SearchOptions options;
+    options.method = SearchMethod::LATIN_HYPERCUBE;
+    options.num_trials = 11;
+    ParamSearch search({{"n", IntRange{0, 20, 2}},
+                        {"x", DoubleRange{1., 100., true}},
+                        {"flag", Choice{{true, false}}}},
+                       options);
+
+    vector<int> seen(11, 0);
+    for (int64_t i = 0; i < options.num_trials; ++i) {
+        auto params = search.ask(i);
+        auto n = std::get<int>(params.at("n"));
+        ASSERT_EQ(n % 2, 0);
+        ++seen[n / 2];
+        auto x = std::get<double>(params.at("x"));
+        ASSERT_GE(x, 1.);
+        ASSERT_LE(x, 100.);
+        ASSERT_TRUE(std::holds_alternative<bool>(params.at("flag")));
+        // asking again gives the same trial
+        ASSERT_EQ(search.ask(i), params);
+    }
+    for (auto count : seen) ASSERT_EQ(count, 1);
+}
+
+TEST(ParamSearchTest, AskTell) {
+    SearchOptions options;
+    options.method = SearchMethod::RANDOM;
+    options.num_trials = 3;
+    options.maximize = false;
+    ParamSearch search({{"x", DoubleRange{0., 1.}}}, options);
+
+    ASSERT_THROW(search.tell(0, 1.), std::out_of_range);
+    ASSERT_THROW(search.ask(3), std::out_of_range);
+
+    // told out of order, NaN is never best
+    search.ask(0);
+    search.ask(1);
+    search.ask(2);
+    search.tell(2, 3.);
+    search.tell(0, std::nan(""));
+    search.tell(1, 2.);
+
+    auto result = search.result();
+    ASSERT_EQ(result.values_.size(), 3u);
+    ASSERT_TRUE(std::isnan(result.values_[0]));
+    ASSERT_EQ(result.best_, 1);
+
+    ASSERT_THROW(ParamSearch({{"n", IntRange{2, 1}}}), std::invalid_argument);
+    ASSERT_THROW(ParamSearch({{"c", Choice{}}}), std::invalid_argument);
+}
+
+TEST(ParamSearchTest, TPEConverges) {
+    SearchOptions options;
+    options.num_trials = 40;
+    ParamSearch search({{"x", DoubleRange{-2., 2.}}}, options);
+
+    for (int64_t i = 0; i < options.num_trials; ++i) {
+        auto x = std::get<double>(search.ask(i).at("x"));
+        search.tell(i, -(x - .3) * (x - .3));
+    }
+    auto result = search.result();
+    auto x = std::get<double>(result.params_[result.best_].at("x"));
+    ASSERT_NEAR(x, .3, .05);
+}
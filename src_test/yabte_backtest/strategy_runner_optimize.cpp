@@ -23,4 +23,74 @@ TEST(RunnerTest, OptimizeSmokeTest) {
         },
         testing::ExitedWithCode(0),
         testing::MatchesRegex(death_test_matcher()));
-}
\ No newline at end of file
+}
+
+TEST(RunnerTest, OptimizeSummaryMatchesRun) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            auto res = test_optimize_02();
+            if (res) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+TEST(RunnerTest, SearchBestMatchesRun) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            auto res = test_optimize_03();
+            if (res) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+TEST(RunnerTest, HalvingFinalistsMatchRun) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            auto res = test_optimize_04();
+            if (res) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+TEST(RunnerTest, ProcessBatchMatchesThreads) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            auto res = test_optimize_05();
+            if (res) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+TEST(RunnerTest, OptimizeSharesIndicatorCache) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            auto res = test_optimize_06();
+            if (res) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
@@ -2,6 +2,7 @@
 
 #include <glog/logging.h>
 
+#include <cmath>
 #include <exception>
 #include <filesystem>
 #include <memory>
@@ -25,6 +26,24 @@ using std::shared_ptr, std::vector, std::exception;
 
 namespace fs = std::filesystem;
 
+// TestSMAXOStrat trading GOOG of the sample data from a 100000 cash book
+inline StrategyRunner sample_runner() {
+    StrategyVector strategies{std::make_shared<TestSMAXOStrat>()};
+    AssetVector assets{std::make_shared<OHLCAsset>("GOOG", "USD")};
+    BookVector books{std::make_shared<Book>("bk1", "USD", 100000.)};
+    return StrategyRunner(sample_table(), assets, strategies, books);
+}
+
+// every (n, m) pair of ns and ms
+inline vector<ParamMap> param_grid(const vector<int>& ns,
+                                   const vector<int>& ms) {
+    vector<ParamMap> param_vector;
+    for (auto n : ns)
+        for (auto m : ms)
+            param_vector.push_back(ParamMap({{"n"s, n}, {"m"s, m}}));
+    return param_vector;
+}
+
 int test_optimize_01() {
     StrategyVector strategies;
     AssetVector assets;
@@ -68,3 +87,189 @@ int test_optimize_01() {
 
     return 0;
 }
+
+int test_optimize_02() {
+    vector<ParamMap> param_vector;
+    for (auto [n, m] : {std::pair{10, 20}, {5, 30}, {20, 10}})
+        param_vector.push_back(ParamMap({{"n"s, n}, {"m"s, m}}));
+
+    try {
+        auto sr = sample_runner();
+        auto summary =
+            sr.run_batch_summary(param_vector, Metrics::builtin(), 2);
+
+        vector<string> names{"m", "n", "final_equity", "sharpe_ratio",
+                             "max_drawdown", "trade_count"};
+        if (summary->ColumnNames() != names ||
+            summary->num_rows() != std::ssize(param_vector)) {
+            LOG(ERROR) << "unexpected summary " << summary->ToString();
+            return -1;
+        }
+
+        // each row reduces the same run as run()
+        for (size_t i = 0; i < param_vector.size(); ++i) {
+            auto srr = sr.run(param_vector[i]);
+            for (auto& [name, metric] : Metrics::builtin()) {
+                auto st_s = summary->GetColumnByName(name)->GetScalar(i);
+                CHECK(st_s.ok()) << "Error: " << st_s.status();
+                auto value =
+                    std::static_pointer_cast<arrow::DoubleScalar>(*st_s)->value;
+                auto expected = metric(srr);
+                if (value != expected &&
+                    !(std::isnan(value) && std::isnan(expected))) {
+                    LOG(ERROR) << name << " mismatch " << value
+                               << " != " << expected;
+                    return -1;
+                }
+            }
+        }
+    } catch (exception& e) {
+        LOG(ERROR) << "strategy summary failed: " << e.what();
+        return -1;
+    }
+
+    return 0;
+}
+
+int test_optimize_03() {
+    try {
+        auto sr = sample_runner();
+        SearchOptions options;
+        options.num_trials = 8;
+        options.startup_trials = 4;
+        options.max_parallelism = 2;
+        auto result = sr.run_search(
+            {{"n", IntRange{5, 50, 5}}, {"m", IntRange{10, 60, 10}}},
+            Metrics::final_equity, options);
+
+        if (std::ssize(result.values_) != options.num_trials ||
+            result.best_ < 0) {
+            LOG(ERROR) << "unexpected search result";
+            return -1;
+        }
+
+        // the best trial is a run like any other
+        auto& best = result.params_[result.best_];
+        for (auto value : result.values_) {
+            if (value > result.values_[result.best_]) {
+                LOG(ERROR) << "best trial is not the best";
+                return -1;
+            }
+        }
+        if (Metrics::final_equity(sr.run(best)) !=
+            result.values_[result.best_]) {
+            LOG(ERROR) << "best trial mismatch for " << best;
+            return -1;
+        }
+    } catch (exception& e) {
+        LOG(ERROR) << "strategy search failed: " << e.what();
+        return -1;
+    }
+
+    return 0;
+}
+
+int test_optimize_04() {
+    auto param_vector = param_grid({5, 10, 20}, {15, 30, 45});
+
+    try {
+        auto sr = sample_runner();
+        HalvingOptions options;
+        options.max_parallelism = 2;
+        auto halving =
+            sr.run_halving(param_vector, Metrics::final_equity, options);
+
+        // a third survive the first rung and run to the end
+        if (halving.finalists_.size() != 3 || halving.results_.size() != 3) {
+            LOG(ERROR) << "unexpected finalists " << halving.finalists_.size();
+            return -1;
+        }
+        int64_t full = 0;
+        for (auto rows : halving.rows_) full += rows == sr.data_->num_rows();
+        if (full != 3) {
+            LOG(ERROR) << "unexpected number of full runs " << full;
+            return -1;
+        }
+
+        // resumed runs match running from scratch
+        for (size_t k = 0; k < halving.finalists_.size(); ++k) {
+            auto& params = param_vector[halving.finalists_[k]];
+            auto expected = Metrics::final_equity(sr.run(params));
+            if (Metrics::final_equity(halving.results_[k]) != expected ||
+                halving.values_[halving.finalists_[k]] != expected) {
+                LOG(ERROR) << "resumed run mismatch for " << params;
+                return -1;
+            }
+        }
+    } catch (exception& e) {
+        LOG(ERROR) << "strategy halving failed: " << e.what();
+        return -1;
+    }
+
+    return 0;
+}
+
+int test_optimize_05() {
+    auto param_vector = param_grid({5, 10, 20}, {15, 30, 45});
+
+    try {
+        auto sr = sample_runner();
+        auto summary = sr.run_batch_summary_processes(param_vector,
+                                                      Metrics::builtin(), 3);
+        auto expected =
+            sr.run_batch_summary(param_vector, Metrics::builtin(), 2);
+
+        // worker processes give the rows the threads give, in order
+        if (summary->ColumnNames() != expected->ColumnNames() ||
+            summary->num_rows() != expected->num_rows()) {
+            LOG(ERROR) << "unexpected summary " << summary->ToString();
+            return -1;
+        }
+        for (auto& [name, _] : Metrics::builtin()) {
+            for (int64_t i = 0; i < summary->num_rows(); ++i) {
+                auto value = std::static_pointer_cast<arrow::DoubleScalar>(
+                                 *summary->GetColumnByName(name)->GetScalar(i))
+                                 ->value;
+                auto other = std::static_pointer_cast<arrow::DoubleScalar>(
+                                 *expected->GetColumnByName(name)->GetScalar(i))
+                                 ->value;
+                if (value != other &&
+                    !(std::isnan(value) && std::isnan(other))) {
+                    LOG(ERROR) << name << " mismatch " << value
+                               << " != " << other;
+                    return -1;
+                }
+            }
+        }
+    } catch (exception& e) {
+        LOG(ERROR) << "strategy process batch failed: " << e.what();
+        return -1;
+    }
+
+    return 0;
+}
+
+int test_optimize_06() {
+    vector<ParamMap> param_vector;
+    for (auto [n, m] : {std::pair{20, 5}, {30, 10}, {40, 15}, {50, 20}})
+        param_vector.push_back(ParamMap({{"n"s, n}, {"m"s, m}}));
+
+    try {
+        auto sr = sample_runner();
+        sr.indicator_cache_ = std::make_shared<IndicatorCache>();
+        auto srrs = sr.run_batch(param_vector, 2);
+
+        // the 20 day average is shared by two parameter sets
+        auto stats = sr.indicator_cache_->stats();
+        if (stats.misses != 7 || stats.hits != 1) {
+            LOG(ERROR) << "unexpected indicator cache stats " << stats.hits
+                       << " hits, " << stats.misses << " misses";
+            return -1;
+        }
+    } catch (exception& e) {
+        LOG(ERROR) << "strategy optimizer failed: " << e.what();
+        return -1;
+    }
+
+    return 0;
+}
@@ -7,6 +7,7 @@
 
 #include "YABTE/BackTest/Asset.hpp"
 #include "YABTE/BackTest/Book.hpp"
+#include "YABTE/BackTest/ExprStrategy.hpp"
 #include "YABTE/BackTest/Order.hpp"
 #include "YABTE/BackTest/Strategy.hpp"
 #include "YABTE/BackTest/StrategyRunner.hpp"
@@ -74,4 +75,336 @@ TEST(RunnerTest, RunSmokeTest) {
         },
         testing::ExitedWithCode(0),
         testing::MatchesRegex(death_test_matcher()));
-}
\ No newline at end of file
+}
+
+void test_runner_day_table_01(bool& success) {
+    success = false;
+
+    StrategyVector strategies{std::make_shared<TestSMAXOStrat>()};
+    AssetVector assets{std::make_shared<OHLCAsset>("GOOG", "USD")};
+    BookVector books{std::make_shared<Book>("bk1", "USD", 100000., 0.0001)};
+    // in two chunks, as a table read from several row groups is
+    auto table = sample_table();
+    auto half = table->num_rows() / 2;
+    auto st_ct =
+        arrow::ConcatenateTables({table->Slice(0, half), table->Slice(half)});
+    ASSERT_TRUE(st_ct.ok()) << "Error: " << st_ct.status();
+    table = st_ct.ValueOrDie();
+
+    // runs share one combined view of the data until it is replaced
+    auto sr = StrategyRunner(table, assets, strategies, books);
+    auto day_table = sr._day_table();
+    vector<ParamMap> params_vector;
+    for (auto [n, m] : {std::pair{10, 20}, {5, 30}})
+        params_vector.push_back({{"n", n}, {"m", m}});
+    auto srrs = sr.run_batch(params_vector, 2);
+    ASSERT_EQ(sr._day_table(), day_table);
+
+    // and the strategies' windows use its columns in place
+    auto& window = srrs[0].strategies_[0]->data_->view_;
+    ASSERT_GT(window.num_columns(), day_table->num_columns());
+    ASSERT_EQ(window.column(0).values, day_table->column(0).values);
+
+    sr.data_ = table->Slice(0, half);
+    ASSERT_NE(sr._day_table(), day_table);
+    ASSERT_EQ(sr._day_table()->num_rows(), half);
+
+    success = true;
+}
+
+TEST(RunnerTest, DayTableSharedByRuns) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            bool success = false;
+            test_runner_day_table_01(success);
+            if (!success) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+void test_runner_lockstep_01(bool& success) {
+    success = false;
+
+    StrategyVector strategies{std::make_shared<TestSMAXOStrat>()};
+    StrategyVector lane_strategies{std::make_shared<TestSMAXOLaneStrat>()};
+
+    // GOOG trades, the others are never held
+    AssetVector assets;
+    for (auto name : {"META", "GOOG", "AMZN"})
+        assets.push_back(std::make_shared<OHLCAsset>(name, "USD"));
+
+    BookVector books{std::make_shared<Book>("bk1", "USD", 100000., 0.0001)};
+    auto table = sample_table();
+
+    vector<ParamMap> params_vector;
+    for (auto [n, m] : {std::pair{10, 20}, {5, 30}, {20, 10}, {15, 40}})
+        params_vector.push_back({{"n", n}, {"m", m}});
+
+    auto sr = StrategyRunner(table, assets, strategies, books);
+    auto lr = StrategyRunner(table, assets, lane_strategies, books);
+    auto lane_results = lr.run_lockstep(params_vector);
+    ASSERT_EQ(lane_results.size(), params_vector.size());
+
+    for (size_t i = 0; i < params_vector.size(); ++i) {
+        auto srr = sr.run(params_vector[i]);
+        auto& lrr = lane_results[i];
+
+        ASSERT_EQ(lrr.orders_processed_.size(), srr.orders_processed_.size());
+        ASSERT_EQ(lrr.orders_unprocessed_->size(),
+                  srr.orders_unprocessed_->size());
+        ASSERT_EQ(lrr.assets_.size(), srr.assets_.size());
+        for (size_t j = 0; j < srr.assets_.size(); ++j)
+            ASSERT_EQ(lrr.assets_[j]->name_, srr.assets_[j]->name_);
+
+        ASSERT_EQ(lrr.books_.size(), 1);
+        auto& lb = *lrr.books_[0];
+        auto& sb = *srr.books_[0];
+        ASSERT_EQ(lb.cash_, sb.cash_);
+        ASSERT_EQ(lb.positions_, sb.positions_);
+        auto lt = lb.transactions(), st = sb.transactions();
+        ASSERT_EQ(lt.size(), st.size());
+        for (size_t j = 0; j < st.size(); ++j) {
+            ASSERT_EQ(lt[j]->total_, st[j]->total_);
+            ASSERT_EQ(lt[j]->desc_, st[j]->desc_);
+        }
+        ASSERT_TRUE(lb.ledger()->Equals(*sb.ledger()));
+        ASSERT_TRUE(lb.history()->Equals(*sb.history()));
+        ASSERT_EQ(lrr.orders_processed_.back()->book_, lrr.books_[0]);
+    }
+
+    success = true;
+}
+
+TEST(RunnerTest, LockstepMatchesRun) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            bool success = false;
+            test_runner_lockstep_01(success);
+            if (!success) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+void test_runner_stream_01(bool& success) {
+    success = false;
+
+    StrategyVector strategies{std::make_shared<TestSMAXOStrat>()};
+    AssetVector assets{std::make_shared<OHLCAsset>("GOOG", "USD")};
+    BookVector books{std::make_shared<Book>("bk1", "USD", 100000., 0.0001)};
+    auto table = sample_table();
+
+    auto sr = StrategyRunner(table, assets, strategies, books);
+    for (auto [n, m] : {std::pair{10, 20}, {5, 30}}) {
+        ParamMap params{{"n", n}, {"m", m}};
+        auto srr = sr.run(params);
+
+        // batches smaller than the lookback so windows span several
+        auto reader = std::make_shared<arrow::TableBatchReader>(table);
+        reader->set_chunksize(7);
+        auto rrr = sr.run_stream(reader, params);
+
+        ASSERT_EQ(rrr.orders_processed_.size(), srr.orders_processed_.size());
+        auto& rb = *rrr.books_[0];
+        auto& sb = *srr.books_[0];
+        ASSERT_EQ(rb.cash_, sb.cash_);
+        ASSERT_EQ(rb.positions_, sb.positions_);
+        ASSERT_EQ(rb.ledger_.size(), sb.ledger_.size());
+        ASSERT_TRUE(rb.history()->Equals(*sb.history()));
+
+        // orders came from each run's arena, fills make no trades
+        ASSERT_GT(srr.arena_stats().allocations, 0);
+        ASSERT_EQ(rrr.arena_stats().allocations,
+                  srr.arena_stats().allocations);
+
+        // only the lookback is held
+        auto& data = *rrr.strategies_[0]->data_;
+        ASSERT_EQ(data.size(), table->num_rows());
+        ASSERT_GT(data.base(), 0);
+
+        // extend_data used the window's cache
+        auto& indicators = rrr.strategies_[0]->indicators_;
+        ASSERT_TRUE(indicators);
+        ASSERT_EQ(indicators->stats().entries, 2);
+    }
+
+    success = true;
+}
+
+TEST(RunnerTest, RunStreamMatchesRun) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            bool success = false;
+            test_runner_stream_01(success);
+            if (!success) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+void test_runner_block_01(bool& success) {
+    success = false;
+
+    AssetVector assets{std::make_shared<OHLCAsset>("GOOG", "USD")};
+    BookVector books{std::make_shared<Book>("bk1", "USD", 100000., 0.0001)};
+    auto table = sample_table();
+
+    auto sr = StrategyRunner(
+        table, assets, {std::make_shared<TestSMAXOStrat>()}, books);
+    // block sizes that do and don't divide the rows or stream batches
+    for (int64_t block_size : {2, 16, 1000}) {
+        auto br = StrategyRunner(
+            table, assets,
+            {std::make_shared<TestSMAXOBlockStrat>(block_size)}, books);
+        ParamMap params{{"n", 10}, {"m", 20}};
+        auto srr = sr.run(params);
+        auto reader = std::make_shared<arrow::TableBatchReader>(table);
+        reader->set_chunksize(7);
+        for (auto brr : {br.run(params), br.run_stream(reader, params)}) {
+            ASSERT_EQ(brr.orders_processed_.size(),
+                      srr.orders_processed_.size());
+            auto& bb = *brr.books_[0];
+            auto& sb = *srr.books_[0];
+            ASSERT_EQ(bb.cash_, sb.cash_);
+            ASSERT_EQ(bb.positions_, sb.positions_);
+            ASSERT_TRUE(bb.history()->Equals(*sb.history()));
+        }
+    }
+
+    success = true;
+}
+
+TEST(RunnerTest, CloseBlockMatchesRun) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            bool success = false;
+            test_runner_block_01(success);
+            if (!success) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+void test_runner_signals_01(bool& success) {
+    success = false;
+
+    StrategyVector strategies{std::make_shared<TestSMATargetStrat>()};
+    AssetVector assets{std::make_shared<OHLCAsset>("GOOG", "USD")};
+    BookVector books{std::make_shared<Book>("bk1", "USD", 100000., 0.0001)};
+    auto table = sample_table();
+
+    auto sr = StrategyRunner(table, assets, strategies, books);
+    for (auto [n, m] : {std::pair{10, 20}, {5, 30}}) {
+        ParamMap params{{"n", n}, {"m", m}};
+        auto srr = sr.run(params);
+        auto vrr = sr.run_signals(params);
+
+        ASSERT_GT(srr.orders_processed_.size(), 0);
+        ASSERT_EQ(vrr.orders_processed_.size(), srr.orders_processed_.size());
+        ASSERT_EQ(vrr.orders_unprocessed_->size(),
+                  srr.orders_unprocessed_->size());
+        auto& vb = *vrr.books_[0];
+        auto& sb = *srr.books_[0];
+        ASSERT_EQ(vb.cash_, sb.cash_);
+        ASSERT_EQ(vb.positions_, sb.positions_);
+        ASSERT_TRUE(vb.history()->Equals(*sb.history()));
+        ASSERT_TRUE(vb.ledger()->Equals(*sb.ledger()));
+    }
+
+    // no signal columns
+    SignalOptions options;
+    options.field = "Missing";
+    ASSERT_THROW(sr.run_signals({{"n", 10}, {"m", 20}}, options),
+                 std::runtime_error);
+
+    success = true;
+}
+
+TEST(RunnerTest, SignalsMatchRun) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            bool success = false;
+            test_runner_signals_01(success);
+            if (!success) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
+
+void test_runner_expr_01(bool& success) {
+    success = false;
+
+    // the crossover of TestSMAXOStrat's (previous day's) moving averages
+    auto source =
+        "cross(lag(sma(Close, n), 1), lag(sma(Close, m), 1)) -> buy 100\n"
+        "cross(lag(sma(Close, m), 1), lag(sma(Close, n), 1)) -> sell 100\n";
+    StrategyVector expr_strategies{
+        std::make_shared<ExprStrategy>(source, "GOOG")};
+    StrategyVector strategies{std::make_shared<TestSMAXOStrat>()};
+    AssetVector assets{std::make_shared<OHLCAsset>("GOOG", "USD")};
+    BookVector books{std::make_shared<Book>("bk1", "USD", 100000., 0.0001)};
+    auto table = sample_table();
+
+    auto sr = StrategyRunner(table, assets, strategies, books);
+    auto er = StrategyRunner(table, assets, expr_strategies, books);
+    for (auto [n, m] : {std::pair{10, 20}, {5, 30}}) {
+        ParamMap params{{"n", n}, {"m", m}};
+        auto srr = sr.run(params);
+        auto err = er.run(params);
+
+        ASSERT_GT(srr.orders_processed_.size(), 0);
+        ASSERT_EQ(err.orders_processed_.size(), srr.orders_processed_.size());
+        ASSERT_EQ(err.orders_unprocessed_->size(),
+                  srr.orders_unprocessed_->size());
+        auto& eb = *err.books_[0];
+        auto& sb = *srr.books_[0];
+        ASSERT_EQ(eb.cash_, sb.cash_);
+        ASSERT_EQ(eb.positions_, sb.positions_);
+        ASSERT_TRUE(eb.history()->Equals(*sb.history()));
+        ASSERT_TRUE(eb.ledger()->Equals(*sb.ledger()));
+    }
+
+    // unknown names fail when the data is extended
+    StrategyVector bad{std::make_shared<ExprStrategy>("Volume2 > 0 -> buy 1",
+                                                      "GOOG")};
+    auto br = StrategyRunner(table, assets, bad, books);
+    ASSERT_THROW(br.run(), std::invalid_argument);
+
+    success = true;
+}
+
+TEST(RunnerTest, ExprMatchesRun) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(
+        {
+            bool success = false;
+            test_runner_expr_01(success);
+            if (!success) {
+                exit(1);
+            }
+            exit(0);
+        },
+        testing::ExitedWithCode(0),
+        testing::MatchesRegex(death_test_matcher()));
+}
@@ -1,6 +1,7 @@
 
 #include "yabte_backtest/test_strategy_01.h"
 
+#include <arrow/builder.h>
 #include <arrow/compute/api.h>
 #include <arrow/io/api.h>
 #include <arrow/table.h>
@@ -14,20 +15,27 @@
 #include "YABTE/Utilities/Arrow/TableHelpers.hpp"
 
 using YABTE::BackTest::AssetDataFieldInfo, YABTE::BackTest::SimpleOrder,
-    YABTE::BackTest::Strategy;
+    YABTE::BackTest::Strategy, YABTE::BackTest::make_run_shared;
 
 using YABTE::Utilities::Arrow::ComputeMovingAverage;
 
 using std::shared_ptr, std::vector;
 
-shared_ptr<Table> MyExtendTable(const shared_ptr<const Table>& table, int n,
-                                int m) {
+shared_ptr<Table> MyExtendTable(
+    const shared_ptr<const Table>& table, int n, int m,
+    const shared_ptr<YABTE::BackTest::IndicatorCache>& indicators) {
     auto vals = table->GetColumnByName("('GOOG', 'Close')");
     auto f0 = arrow::field("('GOOG', 'CloseSMAShort')", arrow::float64());
     auto f1 = arrow::field("('GOOG', 'CloseSMALong')", arrow::float64());
 
-    auto st_cma_short = ComputeMovingAverage(vals, n);
-    auto st_cma_long = ComputeMovingAverage(vals, m);
+    auto moving_average = [&](int k) {
+        auto compute = [&]() { return ComputeMovingAverage(vals, k); };
+        return indicators ? indicators->get_or_compute(
+                                vals, "moving_average", {k}, compute)
+                          : compute();
+    };
+    auto st_cma_short = moving_average(n);
+    auto st_cma_long = moving_average(m);
 
     shared_ptr<ChunkedArray> ma_chunked_arr_short = st_cma_short.ValueOrDie();
     shared_ptr<ChunkedArray> ma_chunked_arr_long = st_cma_long.ValueOrDie();
@@ -47,7 +55,14 @@ shared_ptr<const Table> TestSMAXOStrat::extend_data(
     const shared_ptr<const Table>& data) {
     auto n = std::get<int>(this->params_.at("n"));
     auto m = std::get<int>(this->params_.at("m"));
-    return MyExtendTable(data, n, m);
+    return MyExtendTable(data, n, m, this->indicators_);
+}
+
+int64_t TestSMAXOStrat::lookback() const {
+    // the previous day's moving averages need their full windows
+    auto n = std::get<int>(this->params_.at("n"));
+    auto m = std::get<int>(this->params_.at("m"));
+    return std::max(n, m) + 1;
 }
 
 void TestSMAXOStrat::on_open() {
@@ -62,29 +77,123 @@ void TestSMAXOStrat::on_close() {
     auto n = std::get<int>(this->params_.at("n"));
     auto m = std::get<int>(this->params_.at("m"));
 
-    auto nrows = this->data_->num_rows();
+    auto nrows = this->data_->size();
 
     DLOG(INFO) << "on_close";
     if (nrows >= std::max(n, m) + 2) {
-        auto s_short =
-            this->data_->GetColumnByName("('GOOG', 'CloseSMAShort')");
-        auto s_long = this->data_->GetColumnByName("('GOOG', 'CloseSMALong')");
-
-        std::vector<optional<double>> v_short{
-            arrow::stl::End<arrow::DoubleType>(*s_short) - 2,
-            arrow::stl::End<arrow::DoubleType>(*s_short)};
-        std::vector<optional<double>> v_long{
-            arrow::stl::End<arrow::DoubleType>(*s_long) - 2,
-            arrow::stl::End<arrow::DoubleType>(*s_long)};
-
-        if (v_short[0].value() < v_long[0].value() &&
-            v_short[1].value() > v_long[1].value()) {
-            this->orders_->push_back(
-                std::make_shared<SimpleOrder>("GOOG", 100));
-        } else if (v_long[0].value() < v_short[0].value() &&
-                   v_long[1].value() > v_short[1].value()) {
+        auto s_short = this->data_->column("('GOOG', 'CloseSMAShort')");
+        auto s_long = this->data_->column("('GOOG', 'CloseSMALong')");
+
+        if (s_short.last(1) < s_long.last(1) &&
+            s_short.last(0) > s_long.last(0)) {
+            this->orders_->push_back(make_run_shared<SimpleOrder>("GOOG", 100));
+        } else if (s_long.last(1) < s_short.last(1) &&
+                   s_long.last(0) > s_short.last(0)) {
             this->orders_->push_back(
-                std::make_shared<SimpleOrder>("GOOG", -100));
+                make_run_shared<SimpleOrder>("GOOG", -100));
+        }
+    }
+}
+
+shared_ptr<Strategy> TestSMAXOBlockStrat::clone() const {
+    return std::make_shared<TestSMAXOBlockStrat>(*this);
+}
+
+int64_t TestSMAXOBlockStrat::block_size() const { return this->block_size_; }
+
+vector<vector<shared_ptr<YABTE::BackTest::Order>>>
+TestSMAXOBlockStrat::on_close_block(const int64_t begin, const int64_t end) {
+    auto n = std::get<int>(this->params_.at("n"));
+    auto m = std::get<int>(this->params_.at("m"));
+    auto s_short = this->data_->column("('GOOG', 'CloseSMAShort')");
+    auto s_long = this->data_->column("('GOOG', 'CloseSMALong')");
+
+    // on_close's orders for each row, from that row and the one before
+    vector<vector<shared_ptr<YABTE::BackTest::Order>>> orders(end - begin);
+    for (auto row = begin; row < end; ++row) {
+        if (row + 1 < std::max(n, m) + 2) continue;
+        auto& row_orders = orders[row - begin];
+        if (s_short.at(row - 1) < s_long.at(row - 1) &&
+            s_short.at(row) > s_long.at(row)) {
+            row_orders.push_back(make_run_shared<SimpleOrder>("GOOG", 100));
+        } else if (s_long.at(row - 1) < s_short.at(row - 1) &&
+                   s_long.at(row) > s_short.at(row)) {
+            row_orders.push_back(make_run_shared<SimpleOrder>("GOOG", -100));
+        }
+    }
+    return orders;
+}
+
+shared_ptr<Strategy> TestSMATargetStrat::clone() const {
+    return std::make_shared<TestSMATargetStrat>(*this);
+}
+
+shared_ptr<const Table> TestSMATargetStrat::extend_data(
+    const shared_ptr<const Table>& data) {
+    auto n = std::get<int>(this->params_.at("n"));
+    auto m = std::get<int>(this->params_.at("m"));
+    auto averages = MyExtendTable(data, n, m, this->indicators_);
+
+    DataWindow window(averages, averages->num_rows());
+    auto s_short = window.column("('GOOG', 'CloseSMAShort')");
+    auto s_long = window.column("('GOOG', 'CloseSMALong')");
+    arrow::DoubleBuilder target;
+    for (int64_t i = 0; i < averages->num_rows(); ++i) {
+        auto short_ma = s_short.at(i), long_ma = s_long.at(i);
+        auto st_a = std::isnan(short_ma) || std::isnan(long_ma)
+                        ? target.AppendNull()
+                        : target.Append(short_ma > long_ma ? 100. : 0.);
+        CHECK(st_a.ok()) << "Error: " << st_a;
+    }
+    auto schema =
+        arrow::schema({arrow::field("('GOOG', 'Target')", arrow::float64())});
+    return arrow::Table::Make(schema, {target.Finish().ValueOrDie()});
+}
+
+void TestSMATargetStrat::on_close() {
+    auto target = this->data_->column("('GOOG', 'Target')");
+    if (!target.is_valid(-1)) return;
+    auto positions = (*this->book_map_)["bk1"]->positions();
+    auto size = target.last() - positions["GOOG"];
+    if (size != 0.)
+        this->orders_->push_back(make_run_shared<SimpleOrder>("GOOG", size));
+}
+
+shared_ptr<Strategy> TestSMAXOLaneStrat::clone() const {
+    return std::make_shared<TestSMAXOLaneStrat>(*this);
+}
+
+void TestSMAXOLaneStrat::init_lanes() {
+    this->lane_data_.clear();
+    for (auto& params : this->lane_params_) {
+        auto n = std::get<int>(params.at("n"));
+        auto m = std::get<int>(params.at("m"));
+        this->lane_data_.push_back(std::make_shared<DataWindow>(
+            MyExtendTable(this->data_->view_.table_, n, m, this->indicators_)));
+    }
+}
+
+void TestSMAXOLaneStrat::on_close_lanes(LaneOrders& orders) {
+    auto nrows = this->data_->size();
+
+    for (size_t lane = 0; lane < this->num_lanes(); ++lane) {
+        auto& params = this->lane_params_[lane];
+        auto n = std::get<int>(params.at("n"));
+        auto m = std::get<int>(params.at("m"));
+
+        auto& data = this->lane_data_[lane];
+        data->advance_to(nrows);
+        if (nrows < std::max(n, m) + 2) continue;
+
+        auto s_short = data->column("('GOOG', 'CloseSMAShort')");
+        auto s_long = data->column("('GOOG', 'CloseSMALong')");
+
+        if (s_short.last(1) < s_long.last(1) &&
+            s_short.last(0) > s_long.last(0)) {
+            orders.push(lane, "GOOG", 100);
+        } else if (s_long.last(1) < s_short.last(1) &&
+                   s_long.last(0) > s_short.last(0)) {
+            orders.push(lane, "GOOG", -100);
         }
     }
 }
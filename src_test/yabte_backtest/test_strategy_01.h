@@ -7,16 +7,20 @@
 #include <cmath>
 #include <memory>
 
+#include "YABTE/BackTest/LaneStrategy.hpp"
 #include "YABTE/BackTest/Strategy.hpp"
 
-using YABTE::BackTest::Strategy;
+using YABTE::BackTest::Strategy, YABTE::BackTest::LaneStrategy,
+    YABTE::BackTest::LaneOrders, YABTE::BackTest::DataWindow;
 
 using arrow::Table;
 
 using std::shared_ptr;
 
-shared_ptr<Table> MyExtendTable(const shared_ptr<const Table>& table, int n,
-                                int m);
+// indicators, when given, caches the moving averages across runs
+shared_ptr<Table> MyExtendTable(
+    const shared_ptr<const Table>& table, int n, int m,
+    const shared_ptr<YABTE::BackTest::IndicatorCache>& indicators = nullptr);
 
 class TestSMAXOStrat : public Strategy {
    public:
@@ -25,7 +29,46 @@ class TestSMAXOStrat : public Strategy {
     shared_ptr<Strategy> clone() const override;
     shared_ptr<const Table> extend_data(
         const shared_ptr<const Table>& data) override;
+    int64_t lookback() const override;
 
     void on_open() override;
     void on_close() override;
 };
+
+// TestSMAXOStrat placing its orders a block of days at a time
+class TestSMAXOBlockStrat : public TestSMAXOStrat {
+   public:
+    explicit TestSMAXOBlockStrat(const int64_t block_size)
+        : block_size_(block_size) {}
+
+    shared_ptr<Strategy> clone() const override;
+    int64_t block_size() const override;
+    std::vector<std::vector<shared_ptr<YABTE::BackTest::Order>>>
+    on_close_block(const int64_t begin, const int64_t end) override;
+
+    int64_t block_size_;
+};
+
+// long 100 GOOG while the short moving average is above the long one, as
+// a ('GOOG', 'Target') column for StrategyRunner::run_signals and as
+// orders to reach it from on_close
+class TestSMATargetStrat : public Strategy {
+   public:
+    shared_ptr<Strategy> clone() const override;
+    shared_ptr<const Table> extend_data(
+        const shared_ptr<const Table>& data) override;
+
+    void on_close() override;
+};
+
+// TestSMAXOStrat for lockstep runs
+class TestSMAXOLaneStrat : public LaneStrategy {
+   public:
+    shared_ptr<Strategy> clone() const override;
+
+    void init_lanes() override;
+    void on_close_lanes(LaneOrders& orders) override;
+
+    // extended data per lane
+    std::vector<shared_ptr<DataWindow>> lane_data_;
+};